@@ -2,6 +2,24 @@
 #include <cmath>
 #include <stdexcept>
 #include <string>
+#include <cstring>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <charconv>
+#include <cstdio>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define LABA1_X86_SIMD 1
+#endif
 
 // Пользовательский класс исключений
 class CustomException : public std::exception {
@@ -22,25 +40,1067 @@ public:
     int getErrorCode() const { return errorCode; }
 };
 
-// Функция для вычисления Z1
-double calculateZ1(double a) {
-    if (a == 0 || a == -1) {
-        throw CustomException("Division by zero or invalid input in Z1 calculation", a, 101);
-    }
+// Формула Z1 без проверки допустимости a
+inline double z1Formula(double a) {
     double numerator = (1 + a * a + 2);
     double denominator = (a - std::sqrt(2 * a));
     return numerator / denominator - 2 / (1 - a + a * a);
 }
 
+// Формула Z2 без проверки допустимости a
+inline double z2Formula(double a) {
+    return 1 / (std::sqrt(a + std::sqrt(2)));
+}
+
+// Результат вычисления без исключений: value действителен при errorCode == 0,
+// иначе errorCode - тот же код, что у CustomException (101 или 102)
+struct CalcResult {
+    double value;
+    int errorCode;
+
+    bool ok() const { return errorCode == 0; }
+    explicit operator bool() const { return ok(); }
+};
+
+// Вычисление Z1 без исключений
+CalcResult try_calculateZ1(double a) noexcept {
+    if (a == 0 || a == -1) {
+        return {0.0, 101};
+    }
+    return {z1Formula(a), 0};
+}
+
+// Вычисление Z2 без исключений
+CalcResult try_calculateZ2(double a) noexcept {
+    if (a + std::sqrt(2) == 0) {
+        return {0.0, 102};
+    }
+    return {z2Formula(a), 0};
+}
+
+// Функция для вычисления Z1
+double calculateZ1(double a) {
+    CalcResult result = try_calculateZ1(a);
+    if (!result) {
+        throw CustomException("Division by zero or invalid input in Z1 calculation", a, result.errorCode);
+    }
+    return result.value;
+}
+
 // Функция для вычисления Z2
 double calculateZ2(double a) {
-    if (a + std::sqrt(2) == 0) {
-        throw CustomException("Division by zero in Z2 calculation", a, 102);
+    CalcResult result = try_calculateZ2(a);
+    if (!result) {
+        throw CustomException("Division by zero in Z2 calculation", a, result.errorCode);
     }
-    return 1 / (std::sqrt(a + std::sqrt(2)));
+    return result.value;
+}
+
+// ---------- Пакетное вычисление Z1/Z2 ----------
+//
+// calculateZBatch считает Z1, Z2 и признак |Z1 - Z2| < 1e-6 для n значений a.
+// Недопустимые значения не бросают исключение, а отмечаются в status:
+// бит ZSTATUS_Z1_INVALID - calculateZ1 бросила бы код 101,
+// бит ZSTATUS_Z2_INVALID - calculateZ2 бросила бы код 102;
+// соответствующий результат равен NaN, а equal - 0.
+//
+// Векторные ядра выполняют те же операции (умножение, сложение, деление,
+// sqrt - все с корректным округлением по IEEE 754) в том же порядке, что и
+// calculateZ1/calculateZ2, поэтому результаты совпадают побитово. Условие:
+// скалярный код собран без слияния умножения и сложения в FMA
+// (так по умолчанию для x86-64; -march=native/-mfma без -ffp-contract=off
+// это условие нарушает). Совпадение NaN проверяется как "оба NaN".
+
+const unsigned char ZSTATUS_OK = 0;
+const unsigned char ZSTATUS_Z1_INVALID = 1;
+const unsigned char ZSTATUS_Z2_INVALID = 2;
+
+// Сигнатура пакетного ядра
+using ZBatchKernel = void (*)(const double* a, size_t n, double* z1, double* z2,
+                              unsigned char* equal, unsigned char* status);
+
+// Скалярное ядро (используется без SIMD и для хвостов векторных ядер)
+void calculateZBatchScalar(const double* a, size_t n, double* z1, double* z2,
+                           unsigned char* equal, unsigned char* status) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (size_t i = 0; i < n; ++i) {
+        double x = a[i];
+        unsigned char st = ZSTATUS_OK;
+        double r1 = nan;
+        double r2 = nan;
+        if (x == 0 || x == -1) {
+            st |= ZSTATUS_Z1_INVALID;
+        } else {
+            r1 = z1Formula(x);
+        }
+        if (x + std::sqrt(2) == 0) {
+            st |= ZSTATUS_Z2_INVALID;
+        } else {
+            r2 = z2Formula(x);
+        }
+        z1[i] = r1;
+        z2[i] = r2;
+        equal[i] = std::abs(r1 - r2) < 1e-6 ? 1 : 0;
+        status[i] = st;
+    }
+}
+
+#ifdef LABA1_X86_SIMD
+// Ядро AVX2: 4 значения за итерацию
+__attribute__((target("avx2")))
+void calculateZBatchAvx2(const double* a, size_t n, double* z1, double* z2,
+                         unsigned char* equal, unsigned char* status) {
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d minusOne = _mm256_set1_pd(-1.0);
+    const __m256d sqrt2 = _mm256_set1_pd(std::sqrt(2));
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d nan = _mm256_set1_pd(std::numeric_limits<double>::quiet_NaN());
+    const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+    const __m256d eps = _mm256_set1_pd(1e-6);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(a + i);
+        __m256d xx = _mm256_mul_pd(x, x);
+
+        // Z1 = (1 + a*a + 2) / (a - sqrt(2a)) - 2 / (1 - a + a*a)
+        __m256d numerator = _mm256_add_pd(_mm256_add_pd(one, xx), two);
+        __m256d denominator = _mm256_sub_pd(x, _mm256_sqrt_pd(_mm256_mul_pd(two, x)));
+        __m256d tail = _mm256_div_pd(two, _mm256_add_pd(_mm256_sub_pd(one, x), xx));
+        __m256d r1 = _mm256_sub_pd(_mm256_div_pd(numerator, denominator), tail);
+        __m256d bad1 = _mm256_or_pd(_mm256_cmp_pd(x, zero, _CMP_EQ_OQ), _mm256_cmp_pd(x, minusOne, _CMP_EQ_OQ));
+        r1 = _mm256_blendv_pd(r1, nan, bad1);
+
+        // Z2 = 1 / sqrt(a + sqrt(2))
+        __m256d shifted = _mm256_add_pd(x, sqrt2);
+        __m256d r2 = _mm256_div_pd(one, _mm256_sqrt_pd(shifted));
+        __m256d bad2 = _mm256_cmp_pd(shifted, zero, _CMP_EQ_OQ);
+        r2 = _mm256_blendv_pd(r2, nan, bad2);
+
+        __m256d diff = _mm256_and_pd(_mm256_sub_pd(r1, r2), absMask);
+        int eqBits = _mm256_movemask_pd(_mm256_cmp_pd(diff, eps, _CMP_LT_OQ));
+        int bad1Bits = _mm256_movemask_pd(bad1);
+        int bad2Bits = _mm256_movemask_pd(bad2);
+
+        _mm256_storeu_pd(z1 + i, r1);
+        _mm256_storeu_pd(z2 + i, r2);
+        for (int lane = 0; lane < 4; ++lane) {
+            equal[i + lane] = static_cast<unsigned char>((eqBits >> lane) & 1);
+            status[i + lane] = static_cast<unsigned char>(((bad1Bits >> lane) & 1) * ZSTATUS_Z1_INVALID |
+                                                          ((bad2Bits >> lane) & 1) * ZSTATUS_Z2_INVALID);
+        }
+    }
+    calculateZBatchScalar(a + i, n - i, z1 + i, z2 + i, equal + i, status + i);
+}
+
+// Ядро AVX-512: 8 значений за итерацию, маски вместо blend.
+// AVX-512F включает FMA для zmm, и GCC сливает mul+add в vfmadd, меняя
+// округление, поэтому слияние здесь запрещено явно. Предупреждение
+// -Wmaybe-uninitialized выдаёт сам avx512fintrin.h (_mm512_undefined_pd).
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+__attribute__((target("avx512f"), optimize("fp-contract=off")))
+void calculateZBatchAvx512(const double* a, size_t n, double* z1, double* z2,
+                           unsigned char* equal, unsigned char* status) {
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d two = _mm512_set1_pd(2.0);
+    const __m512d minusOne = _mm512_set1_pd(-1.0);
+    const __m512d sqrt2 = _mm512_set1_pd(std::sqrt(2));
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d nan = _mm512_set1_pd(std::numeric_limits<double>::quiet_NaN());
+    const __m512d eps = _mm512_set1_pd(1e-6);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d x = _mm512_loadu_pd(a + i);
+        __m512d xx = _mm512_mul_pd(x, x);
+
+        __m512d numerator = _mm512_add_pd(_mm512_add_pd(one, xx), two);
+        __m512d denominator = _mm512_sub_pd(x, _mm512_sqrt_pd(_mm512_mul_pd(two, x)));
+        __m512d tail = _mm512_div_pd(two, _mm512_add_pd(_mm512_sub_pd(one, x), xx));
+        __m512d r1 = _mm512_sub_pd(_mm512_div_pd(numerator, denominator), tail);
+        __mmask8 bad1 = _mm512_cmp_pd_mask(x, zero, _CMP_EQ_OQ) | _mm512_cmp_pd_mask(x, minusOne, _CMP_EQ_OQ);
+        r1 = _mm512_mask_blend_pd(bad1, r1, nan);
+
+        __m512d shifted = _mm512_add_pd(x, sqrt2);
+        __m512d r2 = _mm512_div_pd(one, _mm512_sqrt_pd(shifted));
+        __mmask8 bad2 = _mm512_cmp_pd_mask(shifted, zero, _CMP_EQ_OQ);
+        r2 = _mm512_mask_blend_pd(bad2, r2, nan);
+
+        __m512d diff = _mm512_abs_pd(_mm512_sub_pd(r1, r2));
+        __mmask8 eqBits = _mm512_cmp_pd_mask(diff, eps, _CMP_LT_OQ);
+
+        _mm512_storeu_pd(z1 + i, r1);
+        _mm512_storeu_pd(z2 + i, r2);
+        for (int lane = 0; lane < 8; ++lane) {
+            equal[i + lane] = static_cast<unsigned char>((eqBits >> lane) & 1);
+            status[i + lane] = static_cast<unsigned char>(((bad1 >> lane) & 1) * ZSTATUS_Z1_INVALID |
+                                                          ((bad2 >> lane) & 1) * ZSTATUS_Z2_INVALID);
+        }
+    }
+    calculateZBatchScalar(a + i, n - i, z1 + i, z2 + i, equal + i, status + i);
+}
+#pragma GCC diagnostic pop
+#endif
+
+// Выбор лучшего ядра для текущего процессора
+ZBatchKernel selectZBatchKernel(const char** name = nullptr) {
+    const char* chosen = "scalar";
+    ZBatchKernel kernel = calculateZBatchScalar;
+#ifdef LABA1_X86_SIMD
+    if (__builtin_cpu_supports("avx512f")) {
+        chosen = "avx512";
+        kernel = calculateZBatchAvx512;
+    } else if (__builtin_cpu_supports("avx2")) {
+        chosen = "avx2";
+        kernel = calculateZBatchAvx2;
+    }
+#endif
+    if (name) {
+        *name = chosen;
+    }
+    return kernel;
+}
+
+// Пакетное вычисление с выбором ядра при первом вызове
+void calculateZBatch(const double* a, size_t n, double* z1, double* z2,
+                     unsigned char* equal, unsigned char* status) {
+    static const ZBatchKernel kernel = selectZBatchKernel();
+    kernel(a, n, z1, z2, equal, status);
+}
+
+// Доступные на этом процессоре ядра
+std::vector<std::pair<const char*, ZBatchKernel>> availableZBatchKernels() {
+    std::vector<std::pair<const char*, ZBatchKernel>> kernels{{"scalar", calculateZBatchScalar}};
+#ifdef LABA1_X86_SIMD
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.emplace_back("avx2", calculateZBatchAvx2);
+    }
+    if (__builtin_cpu_supports("avx512f")) {
+        kernels.emplace_back("avx512", calculateZBatchAvx512);
+    }
+#endif
+    return kernels;
+}
+
+// ---------- Табличное вычисление Z1/Z2 ----------
+//
+// ZTable<Segments> делит диапазон [lo, hi) на Segments равных сегментов и на
+// каждом хранит кубический интерполянт по 4 узлам Чебышева (в мономиальной
+// форме по t из [-1, 1], вычисление - схема Горнера без sqrt и деления).
+// Таблица строится constexpr-конструктором, поэтому глобальная zTable
+// вычисляется при компиляции.
+//
+// Сегмент остается табличным, только если для него доказана граница ошибки
+// tolerance и он не лежит рядом с особой точкой: 0, 2 (при a = 2
+// a = sqrt(2a)) и -1 для Z1, -sqrt(2) для Z2. Граница - остаточный член
+// интерполяции по 4 узлам Чебышева: |f - p| <= max|f''''| * h^4 / 192, где
+// h - половина сегмента, а max|f''''| на сегменте оценивается сверху по явным
+// формулам четвертой производной (z1/z2FourthDerivativeBound). К ней
+// добавляется запас на округление double: 64 eps на сумму модулей
+// коэффициентов. Там, где функция не определена (a < 0 для Z1, a < -sqrt(2)
+// для Z2), сегмент хранит NaN - тот же результат, что у точного вычисления.
+// Остальные сегменты и значения вне [lo, hi) считаются точно через
+// try_calculateZ1/Z2. Фактическую ошибку на плотной случайной выборке
+// выводит laba1 --table-bench.
+
+// sqrt для constexpr-вычислений (std::sqrt не constexpr): метод Ньютона
+// сверху, до прекращения убывания; отличие от std::sqrt - не больше 1 ulp
+constexpr double constexprSqrt(double x) {
+    if (!(x > 0) || x == std::numeric_limits<double>::infinity()) {
+        return x == 0 || x == std::numeric_limits<double>::infinity() ? x : std::numeric_limits<double>::quiet_NaN();
+    }
+    double r = x > 1 ? x : 1;
+    for (int i = 0; i < 2100; ++i) {
+        double next = 0.5 * (r + x / r);
+        if (next >= r) {
+            break;
+        }
+        r = next;
+    }
+    return r;
 }
 
-int main() {
+// Значение функции в constexpr-контексте; ok == false там, где точное
+// вычисление вернуло бы ошибку, бесконечность или NaN
+struct ZSample {
+    double value;
+    bool ok;
+};
+
+constexpr ZSample constexprZ1(double a) {
+    double root = 2 * a >= 0 ? constexprSqrt(2 * a) : -1;
+    double denominator = a - root;
+    double tailDenominator = 1 - a + a * a;
+    if (a == 0 || a == -1 || root < 0 || denominator == 0 || tailDenominator == 0) {
+        return {0.0, false};
+    }
+    return {(1 + a * a + 2) / denominator - 2 / tailDenominator, true};
+}
+
+constexpr ZSample constexprZ2(double a) {
+    double shifted = a + 1.4142135623730951;
+    if (!(shifted > 0)) {
+        return {0.0, false};
+    }
+    return {1 / constexprSqrt(shifted), true};
+}
+
+// Верхняя оценка |Z1''''| на [x0, x1]; бесконечность, если сегмент задевает
+// a <= 0 или a = 2. При s = sqrt(2a) первая дробь раскладывается как
+// a + 2 + s - 3/s + 7/(s - 2), а 7/(s - 2) = 3.5 (s + 2) / (a - 2), поэтому
+// производные берутся почленно: степени 2a, произведение по формуле Лейбница
+// (каждый множитель оценивается в худшей точке сегмента) и
+// 2/(a^2 - a + 1) = (4/sqrt(3)) Im 1/(a - r), r = 1/2 + i sqrt(3)/2
+constexpr double z1FourthDerivativeBound(double x0, double x1) {
+    double distanceTo2 = x1 < 2 ? 2 - x1 : x0 - 2;
+    if (!(x0 > 0) || !(distanceTo2 > 0)) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double r = 2 * x0;
+    double s = constexprSqrt(r);
+    // Модули производных u = s + 2 порядков 0..4 и v = 3.5 / (a - 2) порядков 0..4
+    double u[5] = {constexprSqrt(2 * x1) + 2, 1 / s, 1 / (r * s), 3 / (r * r * s), 15 / (r * r * r * s)};
+    double v[5] = {};
+    double power = distanceTo2;
+    double factorial = 1;
+    for (int j = 0; j < 5; ++j) {
+        v[j] = 3.5 * factorial / power;
+        power *= distanceTo2;
+        factorial *= j + 1;
+    }
+    double product = u[0] * v[4] + 4 * u[1] * v[3] + 6 * u[2] * v[2] + 4 * u[3] * v[1] + u[4] * v[0];
+    double roots = 15 / (r * r * r * s) + 315 / (r * r * r * r * s);
+
+    double nearest = x0 > 0.5 ? x0 : x1 < 0.5 ? x1 : 0.5;
+    double distance2 = (nearest - 0.5) * (nearest - 0.5) + 0.75;
+    double tail = 96 / 1.7320508075688772 / (distance2 * distance2 * constexprSqrt(distance2));
+    return roots + product + tail;
+}
+
+// Верхняя оценка |Z2''''| = 105/16 (a + sqrt(2))^(-9/2) на [x0, x1]
+constexpr double z2FourthDerivativeBound(double x0, double) {
+    double shifted = x0 + 1.4142135623730951;
+    if (!(shifted > 0)) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double squared = shifted * shifted;
+    return 105.0 / 16 / (squared * squared * constexprSqrt(shifted));
+}
+
+template <size_t Segments>
+class ZTable {
+public:
+    // Коэффициенты кубического многочлена по t. NaN только в c[0] - точное
+    // вычисление; NaN во всех коэффициентах - функция здесь не определена, и
+    // многочлен дает NaN с кодом 0, как и точное вычисление
+    struct Segment {
+        double c[4];
+    };
+
+    // Z1 и Z2 одного сегмента лежат в одной кэш-линии
+    struct alignas(64) Cell {
+        Segment z1;
+        Segment z2;
+    };
+
+    constexpr ZTable(double from, double to, double maxAbsError)
+        : lo(from), hi(to), step((to - from) / Segments), invStep(Segments / (to - from)),
+          tolerance(maxAbsError), cells() {
+        const double sqrt2 = 1.4142135623730951;
+        for (size_t i = 0; i < Segments; ++i) {
+            double x0 = lo + step * i;
+            double x1 = x0 + step;
+            bool nearZ1Singularity = nearPoint(x0, x1, 0.0) || nearPoint(x0, x1, 2.0) || nearPoint(x0, x1, -1.0);
+            bool nearZ2Singularity = nearPoint(x0, x1, -sqrt2);
+            // При a < 0 у Z1 и a < -sqrt(2) у Z2 корень от отрицательного числа
+            bool z1Undefined = x1 <= 0;
+            bool z2Undefined = x1 <= -sqrt2;
+            cells[i].z1 = nearZ1Singularity ? exactSegment() : z1Undefined ? undefinedSegment() : fit(x0, x1, constexprZ1, z1FourthDerivativeBound);
+            cells[i].z2 = nearZ2Singularity ? exactSegment() : z2Undefined ? undefinedSegment() : fit(x0, x1, constexprZ2, z2FourthDerivativeBound);
+        }
+    }
+
+    // Z1: табличное значение или точное вычисление (с кодом ошибки 101)
+    CalcResult z1(double a) const noexcept {
+        double t;
+        const Cell* cell = find(a, t);
+        return cell && tabulated(cell->z1) ? CalcResult{evaluate(cell->z1, t), 0} : try_calculateZ1(a);
+    }
+
+    // Z2: табличное значение или точное вычисление (с кодом ошибки 102)
+    CalcResult z2(double a) const noexcept {
+        double t;
+        const Cell* cell = find(a, t);
+        return cell && tabulated(cell->z2) ? CalcResult{evaluate(cell->z2, t), 0} : try_calculateZ2(a);
+    }
+
+    // Z1 и Z2 за один поиск сегмента. Проверка табличности идет до вычисления
+    // многочлена: ветвление по результату многочлена удлиняет цепочку зависимостей
+    void evaluateBoth(double a, CalcResult& z1, CalcResult& z2) const noexcept {
+        double t;
+        const Cell* cell = find(a, t);
+        if (cell && tabulated(cell->z1) && tabulated(cell->z2)) {
+            z1 = CalcResult{evaluate(cell->z1, t), 0};
+            z2 = CalcResult{evaluate(cell->z2, t), 0};
+            return;
+        }
+        z1 = this->z1(a);
+        z2 = this->z2(a);
+    }
+
+    // Доля табличных сегментов (для отчета)
+    constexpr double coverageZ1() const { return coverage(&Cell::z1); }
+    constexpr double coverageZ2() const { return coverage(&Cell::z2); }
+
+    constexpr double lower() const { return lo; }
+    constexpr double upper() const { return hi; }
+    constexpr double maxError() const { return tolerance; }
+
+private:
+    double lo;
+    double hi;
+    double step;
+    double invStep;
+    double tolerance;
+    Cell cells[Segments];
+
+    // Сегмент [x0, x1] вместе с соседними содержит точку p
+    constexpr bool nearPoint(double x0, double x1, double p) const {
+        return p >= x0 - step && p <= x1 + step;
+    }
+
+    static constexpr Segment exactSegment() {
+        return Segment{{std::numeric_limits<double>::quiet_NaN(), 0, 0, 0}};
+    }
+
+    static constexpr Segment undefinedSegment() {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        return Segment{{nan, nan, nan, nan}};
+    }
+
+    constexpr Segment fit(double x0, double x1, ZSample (*f)(double), double (*fourthDerivative)(double, double)) const {
+        const Segment exactOnly = exactSegment();
+        // Узлы Чебышева cos(pi (2k + 1) / 8) на [-1, 1]
+        const double nodes[4] = {0.9238795325112867, 0.3826834323650898, -0.3826834323650898, -0.9238795325112867};
+        double mid = 0.5 * (x0 + x1);
+        double half = 0.5 * (x1 - x0);
+        double cheb[4] = {0, 0, 0, 0};
+        for (int k = 0; k < 4; ++k) {
+            ZSample sample = f(mid + half * nodes[k]);
+            if (!sample.ok) {
+                return exactOnly;
+            }
+            double t = nodes[k];
+            double basis[4] = {1, t, 2 * t * t - 1, 4 * t * t * t - 3 * t};
+            for (int j = 0; j < 4; ++j) {
+                cheb[j] += sample.value * basis[j] / 2;
+            }
+        }
+        cheb[0] /= 2;
+        // T0..T3 в мономы: p(t) = c0 - c2 + (c1 - 3 c3) t + 2 c2 t^2 + 4 c3 t^3
+        Segment segment{{cheb[0] - cheb[2], cheb[1] - 3 * cheb[3], 2 * cheb[2], 4 * cheb[3]}};
+
+        // Остаточный член: max|f''''| / 4! * max|prod(t - t_k)| * h^4, где
+        // для узлов Чебышева max|prod(t - t_k)| = 2^-3
+        double h2 = half * half;
+        double bound = fourthDerivative(x0, x1) * h2 * h2 / 192;
+        double magnitude = 0;
+        for (double c : segment.c) {
+            magnitude += c < 0 ? -c : c;
+        }
+        bound += 64 * std::numeric_limits<double>::epsilon() * magnitude;
+        return bound <= tolerance ? segment : exactOnly;
+    }
+
+    // Ячейка для a и координата t внутри сегмента; nullptr вне [lo, hi)
+    const Cell* find(double a, double& t) const {
+        double position = (a - lo) * invStep;
+        if (!(position >= 0 && position < Segments)) {
+            return nullptr;
+        }
+        long index = static_cast<long>(position);
+        t = 2 * (position - index) - 1;
+        return &cells[index];
+    }
+
+    static constexpr bool tabulated(const Segment& segment) {
+        return segment.c[0] == segment.c[0] || segment.c[1] != segment.c[1];
+    }
+
+    static constexpr double evaluate(const Segment& segment, double t) {
+        return ((segment.c[3] * t + segment.c[2]) * t + segment.c[1]) * t + segment.c[0];
+    }
+
+    constexpr double coverage(Segment Cell::*member) const {
+        size_t tabulated = 0;
+        for (size_t i = 0; i < Segments; ++i) {
+            tabulated += this->tabulated(cells[i].*member) ? 1 : 0;
+        }
+        return static_cast<double>(tabulated) / Segments;
+    }
+};
+
+// Таблица по умолчанию захватывает все особые точки, чтобы --table-bench
+// проверял и переход на точное вычисление рядом с ними
+constexpr ZTable<1024> zTable(-1.5, 10.5, 1e-8);
+
+// Значения для проверки: случайные a и все особые точки
+std::vector<double> makeZSamples(size_t n) {
+    std::vector<double> values{0.0, -0.0, -1.0, 2.0, -std::sqrt(2), 1.0, -2.0, 1e-300, 1e300,
+                               std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN()};
+    std::mt19937_64 rng(12345);
+    std::uniform_real_distribution<double> wide(-10.0, 10.0);
+    while (values.size() < n) {
+        values.push_back(wide(rng));
+    }
+    return values;
+}
+
+bool sameResult(double x, double y) {
+    return (std::isnan(x) && std::isnan(y)) || std::memcmp(&x, &y, sizeof(double)) == 0;
+}
+
+// Сравнение каждого ядра с calculateZ1/calculateZ2 (laba1 --batch-check)
+bool checkZBatchKernels() {
+    std::vector<double> a = makeZSamples(100003);
+    size_t n = a.size();
+    bool allOk = true;
+    for (const auto& entry : availableZBatchKernels()) {
+        std::vector<double> z1(n), z2(n);
+        std::vector<unsigned char> equal(n), status(n);
+        entry.second(a.data(), n, z1.data(), z2.data(), equal.data(), status.data());
+
+        size_t mismatches = 0;
+        for (size_t i = 0; i < n; ++i) {
+            unsigned char expectedStatus = ZSTATUS_OK;
+            double expected1 = std::numeric_limits<double>::quiet_NaN();
+            double expected2 = std::numeric_limits<double>::quiet_NaN();
+            try {
+                expected1 = calculateZ1(a[i]);
+            } catch (const CustomException& e) {
+                expectedStatus |= e.getErrorCode() == 101 ? ZSTATUS_Z1_INVALID : 0;
+            }
+            try {
+                expected2 = calculateZ2(a[i]);
+            } catch (const CustomException& e) {
+                expectedStatus |= e.getErrorCode() == 102 ? ZSTATUS_Z2_INVALID : 0;
+            }
+            unsigned char expectedEqual = std::abs(expected1 - expected2) < 1e-6 ? 1 : 0;
+            if (!sameResult(z1[i], expected1) || !sameResult(z2[i], expected2) ||
+                status[i] != expectedStatus || equal[i] != expectedEqual) {
+                ++mismatches;
+            }
+        }
+        std::cout << entry.first << ": " << (mismatches == 0 ? "bit-exact" : "MISMATCH") << " on " << n
+                  << " values (" << mismatches << " mismatches)" << std::endl;
+        allOk = allOk && mismatches == 0;
+    }
+    return allOk;
+}
+
+// Пропускная способность ядер в сравнении с поэлементными вызовами (laba1 --batch-bench)
+void benchmarkZBatchKernels() {
+    const size_t n = 10000000;
+    std::vector<double> a = makeZSamples(n);
+    std::vector<double> z1(n), z2(n);
+    std::vector<unsigned char> equal(n), status(n);
+
+    auto start = std::chrono::steady_clock::now();
+    size_t equalCount = 0;
+    for (size_t i = 0; i < n; ++i) {
+        try {
+            double r1 = calculateZ1(a[i]);
+            double r2 = calculateZ2(a[i]);
+            equalCount += std::abs(r1 - r2) < 1e-6;
+        } catch (const CustomException&) {
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "calculateZ1/Z2 loop: " << n / seconds / 1e6 << " M values/s (equal: " << equalCount << ")" << std::endl;
+
+    for (const auto& entry : availableZBatchKernels()) {
+        start = std::chrono::steady_clock::now();
+        entry.second(a.data(), n, z1.data(), z2.data(), equal.data(), status.data());
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << entry.first << " batch: " << n / seconds / 1e6 << " M values/s" << std::endl;
+    }
+}
+
+// Путь с исключением против пути с кодом ошибки (laba1 --error-bench):
+// доля failureRate значений a недопустима (a = 0, код 101)
+void benchmarkErrorPaths() {
+    const size_t n = 2000000;
+    std::mt19937_64 rng(2024);
+    std::uniform_real_distribution<double> valid(0.5, 10.0);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    for (double failureRate : {0.0, 0.001, 0.01, 0.1, 0.5}) {
+        std::vector<double> a(n);
+        for (double& value : a) {
+            value = coin(rng) < failureRate ? 0.0 : valid(rng);
+        }
+
+        double sum = 0;
+        size_t failures = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (double value : a) {
+            try {
+                sum += calculateZ1(value) + calculateZ2(value);
+            } catch (const CustomException& e) {
+                failures += e.getErrorCode() == 101;
+            }
+        }
+        double throwNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / n;
+
+        start = std::chrono::steady_clock::now();
+        for (double value : a) {
+            CalcResult z1 = try_calculateZ1(value);
+            CalcResult z2 = try_calculateZ2(value);
+            if (z1 && z2) {
+                sum += z1.value + z2.value;
+            } else {
+                failures += z1.errorCode == 101;
+            }
+        }
+        double resultNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / n;
+
+        std::cout << "failures " << failureRate * 100 << "%: throw " << throwNs << " ns/value, result "
+                  << resultNs << " ns/value (checksum " << sum + failures << ")" << std::endl;
+    }
+}
+
+// Таблица против точного вычисления на n случайных a из [lo, hi)
+void compareZTable(double lo, double hi, size_t n) {
+    std::mt19937_64 rng(99);
+    std::uniform_real_distribution<double> inRange(lo, hi);
+    std::vector<double> a(n);
+    for (double& value : a) {
+        value = inRange(rng);
+    }
+
+    double sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (double value : a) {
+        sum += try_calculateZ1(value).value + try_calculateZ2(value).value;
+    }
+    double exactNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / n;
+    start = std::chrono::steady_clock::now();
+    for (double value : a) {
+        CalcResult z1, z2;
+        zTable.evaluateBoth(value, z1, z2);
+        sum += z1.value + z2.value;
+    }
+    double tableNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / n;
+    std::cout << "a in [" << lo << ", " << hi << "): exact " << exactNs << " ns/value, table " << tableNs
+              << " ns/value, speedup " << exactNs / tableNs << "x (checksum " << sum << ")" << std::endl;
+}
+
+// Табличное вычисление (laba1 --table-bench): покрытие, скорость и
+// максимальная абсолютная ошибка на плотной случайной выборке
+bool benchmarkZTable() {
+    std::cout << "range [" << zTable.lower() << ", " << zTable.upper() << "), tabulated segments: Z1 "
+              << zTable.coverageZ1() * 100 << "%, Z2 " << zTable.coverageZ2() * 100 << "%" << std::endl;
+
+    const size_t n = 10000000;
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> inRange(zTable.lower(), zTable.upper());
+    double maxError1 = 0;
+    double maxError2 = 0;
+    for (size_t i = 0; i < n; ++i) {
+        double value = inRange(rng);
+        CalcResult exact1 = try_calculateZ1(value);
+        CalcResult exact2 = try_calculateZ2(value);
+        CalcResult table1 = zTable.z1(value);
+        CalcResult table2 = zTable.z2(value);
+        if (exact1 && std::isfinite(exact1.value)) {
+            maxError1 = std::max(maxError1, std::abs(table1.value - exact1.value));
+        }
+        if (exact2 && std::isfinite(exact2.value)) {
+            maxError2 = std::max(maxError2, std::abs(table2.value - exact2.value));
+        }
+    }
+    std::cout << "max abs error: Z1 " << maxError1 << ", Z2 " << maxError2 << " (bound " << zTable.maxError()
+              << ")" << std::endl;
+
+    // Весь диапазон, где часть значений рядом с особыми точками идет мимо
+    // таблицы (переходы между путями стоят ошибок предсказания ветвлений), и
+    // гладкая часть [3, upper), где табличны все сегменты
+    compareZTable(zTable.lower(), zTable.upper(), n);
+    compareZTable(3.0, zTable.upper(), n);
+    return maxError1 <= zTable.maxError() && maxError2 <= zTable.maxError();
+}
+
+// ---------- Перебор значений a (laba1 --sweep / --sweep-file) ----------
+//
+// Значения делятся на блоки по SWEEP_BLOCK_ROWS. Рабочие потоки по очереди
+// забирают блоки, считают их пакетным ядром calculateZBatch и сами форматируют
+// строки "a,Z1,Z2,equal,error" в текстовый буфер блока. Главный поток только
+// записывает готовые буферы в файл строго по порядку. Блоков в работе не
+// больше SWEEP_SLOTS_PER_THREAD на поток: поток, опередивший запись, ждет,
+// пока освободится ячейка его блока, поэтому память ограничена и не зависит от
+// числа точек (миллиард точек - те же несколько мегабайт).
+
+const size_t SWEEP_BLOCK_ROWS = 16384;
+const size_t SWEEP_SLOTS_PER_THREAD = 4;
+const size_t SWEEP_ROW_MAX = 5 * 32; // Худшая длина строки: 3 double по 24 символа + коды
+const double SWEEP_MAX_ROWS = 1e12;  // Больше точек в диапазоне - заведомо ошибка в аргументах
+const size_t SWEEP_WORD_MAX = 512;   // Более длинное слово в файле не число: пропускается
+
+// Блок значений в работе
+struct SweepBlock {
+    enum State { Free, Filling, Ready };
+
+    State state = Free;
+    uint64_t index = 0;          // Номер блока; запись идет по возрастанию
+    std::string raw;             // Текст из файла (режим --sweep-file)
+    std::vector<double> a;
+    std::vector<double> z1;
+    std::vector<double> z2;
+    std::vector<unsigned char> equal;
+    std::vector<unsigned char> status;
+    std::vector<char> text;      // Отформатированные строки
+    size_t textSize = 0;
+    size_t skipped = 0;          // Нечисловые и слишком длинные слова
+};
+
+// Число точек a_i = from + i * step, не выходящих за to; 0 - диапазон не задан
+// или в нем больше SWEEP_MAX_ROWS точек (в том числе (to - from) / step = inf)
+uint64_t sweepRowCount(double from, double to, double step) {
+    double ratio = (to - from) / step;
+    if (!(ratio >= 0) || !(ratio < SWEEP_MAX_ROWS)) {
+        return 0;
+    }
+    // floor(ratio) может ошибиться на единицу из-за округления деления,
+    // поэтому последняя точка проверяется тем же выражением, что и в next
+    uint64_t count = static_cast<uint64_t>(ratio) + 1;
+    while (count > 1 && from + step * static_cast<double>(count - 1) > to) {
+        --count;
+    }
+    while (from + step * static_cast<double>(count) <= to) {
+        ++count;
+    }
+    return count;
+}
+
+// Источник значений: диапазон с шагом или текстовый файл с числами через пробелы
+class SweepSource {
+public:
+    // Диапазон из count точек a_i = from + i * step, без накопления ошибки
+    SweepSource(double first, double increment, uint64_t points)
+        : input(nullptr), from(first), step(increment), count(points), produced(0) {}
+
+    explicit SweepSource(std::FILE* file) : input(file), from(0), step(0), count(0), produced(0) {}
+
+    // Заполняет следующий блок; false - данные кончились.
+    // Файл читается кусками фиксированного размера, разбор чисел - в рабочих потоках
+    bool next(SweepBlock& block) {
+        block.raw.clear();
+        block.a.clear();
+        if (!input) {
+            if (produced >= count) {
+                return false;
+            }
+            uint64_t rows = std::min<uint64_t>(SWEEP_BLOCK_ROWS, count - produced);
+            block.a.resize(rows);
+            for (uint64_t i = 0; i < rows; ++i) {
+                block.a[i] = from + step * static_cast<double>(produced + i);
+            }
+            produced += rows;
+            return true;
+        }
+
+        block.skipped = 0;
+        block.raw.swap(carry);
+        carry.clear();
+        for (;;) {
+            size_t old = block.raw.size();
+            block.raw.resize(old + SWEEP_BLOCK_ROWS * 8);
+            size_t got = std::fread(&block.raw[old], 1, block.raw.size() - old, input);
+            block.raw.resize(old + got);
+            if (droppingWord) {
+                // Хвост слишком длинного слова отбрасывается до ближайшего разделителя
+                size_t separator = block.raw.find_first_of(" \t\r\n");
+                block.raw.erase(0, separator);
+                droppingWord = separator == std::string::npos;
+            }
+            if (got == 0) {
+                break;
+            }
+            // Незаконченное слово переносится в следующий блок, если оно не
+            // длиннее SWEEP_WORD_MAX: иначе оно пропускается целиком, и carry
+            // не растет на файле без пробелов
+            size_t cut = block.raw.find_last_of(" \t\r\n");
+            size_t tail = cut == std::string::npos ? 0 : cut + 1;
+            if (block.raw.size() - tail > SWEEP_WORD_MAX) {
+                ++block.skipped;
+                droppingWord = true;
+            } else {
+                carry.assign(block.raw, tail, std::string::npos);
+            }
+            block.raw.resize(tail);
+            if (!block.raw.empty()) {
+                break;
+            }
+        }
+        return !block.raw.empty() || block.skipped > 0;
+    }
+
+private:
+    std::FILE* input;
+    std::string carry;
+    bool droppingWord = false;
+    double from;
+    double step;
+    uint64_t count;
+    uint64_t produced;
+};
+
+// Разбор чисел из текста блока
+void parseSweepBlock(SweepBlock& block) {
+    const char* p = block.raw.data();
+    const char* end = p + block.raw.size();
+    while (p < end) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+            ++p;
+        }
+        if (p == end) {
+            break;
+        }
+        const char* wordEnd = p;
+        while (wordEnd < end && *wordEnd != ' ' && *wordEnd != '\t' && *wordEnd != '\r' && *wordEnd != '\n') {
+            ++wordEnd;
+        }
+        // Число должно занимать слово целиком: "1.5xyz" - нечисловое слово
+        double value;
+        std::from_chars_result parsed = std::from_chars(p, wordEnd, value);
+        if (static_cast<size_t>(wordEnd - p) <= SWEEP_WORD_MAX && parsed.ec == std::errc() && parsed.ptr == wordEnd) {
+            block.a.push_back(value);
+        } else {
+            ++block.skipped;
+        }
+        p = wordEnd;
+    }
+}
+
+// Запись значения в строку результата; NaN всегда пишется как "nan"
+// (to_chars выводит знак NaN, и одинаковые ошибки выглядели бы по-разному)
+char* formatSweepValue(char* out, double value) {
+    if (std::isnan(value)) {
+        std::memcpy(out, "nan", 3);
+        return out + 3;
+    }
+    return std::to_chars(out, out + 32, value).ptr;
+}
+
+// Вычисление и форматирование блока; error - код исключения, которое бросил бы
+// интерактивный режим (сначала проверяется Z1): 0, 101 или 102
+void computeSweepBlock(SweepBlock& block) {
+    size_t n = block.a.size();
+    block.z1.resize(n);
+    block.z2.resize(n);
+    block.equal.resize(n);
+    block.status.resize(n);
+    calculateZBatch(block.a.data(), n, block.z1.data(), block.z2.data(), block.equal.data(), block.status.data());
+
+    if (block.text.size() < n * SWEEP_ROW_MAX) {
+        block.text.resize(n * SWEEP_ROW_MAX);
+    }
+    char* out = block.text.data();
+    for (size_t i = 0; i < n; ++i) {
+        int error = block.status[i] & ZSTATUS_Z1_INVALID ? 101 : block.status[i] & ZSTATUS_Z2_INVALID ? 102 : 0;
+        out = formatSweepValue(out, block.a[i]);
+        *out++ = ',';
+        out = formatSweepValue(out, block.z1[i]);
+        *out++ = ',';
+        out = formatSweepValue(out, block.z2[i]);
+        *out++ = ',';
+        *out++ = error == 0 && block.equal[i] ? '1' : '0';
+        *out++ = ',';
+        out = std::to_chars(out, out + 8, error).ptr;
+        *out++ = '\n';
+    }
+    block.textSize = static_cast<size_t>(out - block.text.data());
+}
+
+// Перебор: threads рабочих потоков, запись в output; возвращает число строк
+uint64_t runSweep(SweepSource& source, std::FILE* output, unsigned threads, size_t& skipped) {
+    std::vector<SweepBlock> slots(threads * SWEEP_SLOTS_PER_THREAD);
+    std::mutex mutex;
+    std::condition_variable slotFreed;
+    std::condition_variable slotReady;
+    uint64_t nextBlock = 0;
+    uint64_t blockCount = UINT64_MAX; // Известно, когда источник исчерпан
+
+    auto worker = [&] {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (nextBlock < blockCount) {
+            uint64_t index = nextBlock;
+            SweepBlock& block = slots[index % slots.size()];
+            slotFreed.wait(lock, [&] {
+                return block.state == SweepBlock::Free || nextBlock != index || nextBlock >= blockCount;
+            });
+            if (nextBlock != index || nextBlock >= blockCount) {
+                continue; // Блок уже забрал другой поток или данные кончились
+            }
+            if (!source.next(block)) {
+                blockCount = index;
+                slotReady.notify_all();
+                slotFreed.notify_all();
+                break;
+            }
+            ++nextBlock;
+            block.index = index;
+            block.state = SweepBlock::Filling;
+            lock.unlock();
+
+            if (!block.raw.empty()) {
+                parseSweepBlock(block);
+            }
+            computeSweepBlock(block);
+
+            lock.lock();
+            block.state = SweepBlock::Ready;
+            slotReady.notify_all();
+            slotFreed.notify_all(); // Разбудить потоки, ждущие смены nextBlock
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 0; i < threads; ++i) {
+        pool.emplace_back(worker);
+    }
+
+    uint64_t rows = 0;
+    skipped = 0;
+    for (uint64_t index = 0;; ++index) {
+        SweepBlock& block = slots[index % slots.size()];
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            slotReady.wait(lock, [&] {
+                return (block.state == SweepBlock::Ready && block.index == index) || index >= blockCount;
+            });
+            if (index >= blockCount) {
+                break;
+            }
+        }
+        // Запись без мьютекса: ячейку никто не трогает, пока она Ready
+        std::fwrite(block.text.data(), 1, block.textSize, output);
+        rows += block.a.size();
+        skipped += block.skipped;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            block.state = SweepBlock::Free;
+        }
+        slotFreed.notify_all();
+    }
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+    return rows;
+}
+
+// laba1 --sweep <from> <to> <step> [out.csv]
+// laba1 --sweep-file <in.txt> [out.csv]
+// Без имени выходного файла (или с "-") строки идут в стандартный вывод,
+// статистика - в стандартный поток ошибок
+int runSweepCommand(int argc, char* argv[]) {
+    bool fromFile = std::strcmp(argv[1], "--sweep-file") == 0;
+    int outArg = fromFile ? 3 : 5;
+    if (argc < outArg) {
+        std::cerr << "Usage: " << argv[0] << " --sweep <from> <to> <step> [out.csv]" << std::endl;
+        std::cerr << "       " << argv[0] << " --sweep-file <in.txt> [out.csv]" << std::endl;
+        return 1;
+    }
+
+    std::FILE* input = nullptr;
+    double from = 0, to = 0, step = 0;
+    uint64_t count = 0;
+    if (fromFile) {
+        input = std::fopen(argv[2], "rb");
+        if (!input) {
+            std::cerr << "Error: cannot open " << argv[2] << std::endl;
+            return 1;
+        }
+    } else {
+        from = std::strtod(argv[2], nullptr);
+        to = std::strtod(argv[3], nullptr);
+        step = std::strtod(argv[4], nullptr);
+        if (!(step > 0) || !(to >= from) || !std::isfinite(from) || !std::isfinite(to)) {
+            std::cerr << "Error: expected finite from <= to and step > 0" << std::endl;
+            return 1;
+        }
+        count = sweepRowCount(from, to, step);
+        if (count == 0) {
+            std::cerr << "Error: more than " << SWEEP_MAX_ROWS << " points between from and to" << std::endl;
+            return 1;
+        }
+    }
+
+    std::FILE* output = stdout;
+    if (argc > outArg && std::strcmp(argv[outArg], "-") != 0) {
+        output = std::fopen(argv[outArg], "wb");
+        if (!output) {
+            std::cerr << "Error: cannot open " << argv[outArg] << " for writing" << std::endl;
+            if (input) {
+                std::fclose(input);
+            }
+            return 1;
+        }
+    }
+    // setvbuf - до первой записи в поток; буфер статический, потому что stdout
+    // пользуется им до завершения программы
+    static char outputBuffer[1 << 20];
+    std::setvbuf(output, outputBuffer, _IOFBF, sizeof(outputBuffer));
+    std::fputs("a,Z1,Z2,equal,error\n", output);
+
+    SweepSource source = fromFile ? SweepSource(input) : SweepSource(from, step, count);
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t skipped = 0;
+    auto start = std::chrono::steady_clock::now();
+    uint64_t rows = runSweep(source, output, threads, skipped);
+    bool writeFailed = std::fflush(output) != 0 || std::ferror(output);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (output != stdout) {
+        writeFailed = std::fclose(output) != 0 || writeFailed;
+    }
+    if (input) {
+        std::fclose(input);
+    }
+
+    std::cerr << rows << " rows in " << seconds << " s (" << rows / seconds / 1e6 << " M rows/s, " << threads
+              << " threads)";
+    if (skipped > 0) {
+        std::cerr << ", skipped " << skipped << " non-numeric words";
+    }
+    std::cerr << std::endl;
+    if (writeFailed) {
+        std::cerr << "Error: write failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && (std::strcmp(argv[1], "--sweep") == 0 || std::strcmp(argv[1], "--sweep-file") == 0)) {
+        return runSweepCommand(argc, argv);
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--batch-check") == 0) {
+        return checkZBatchKernels() ? 0 : 1;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--error-bench") == 0) {
+        benchmarkErrorPaths();
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--table-bench") == 0) {
+        return benchmarkZTable() ? 0 : 1;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--batch-bench") == 0) {
+        benchmarkZBatchKernels();
+        return 0;
+    }
+
     double a;
     std::cout << "Enter the value of a: ";
     std::cin >> a;
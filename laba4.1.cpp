@@ -1,17 +1,823 @@
 #include <iostream>
 #include <iomanip>
+#include <cstdio>
+#include <cstddef>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
 
-int main() {
-    std::cout << "Введите символы (для выхода нажмите Ctrl+D в Linux/macOS или Ctrl+Z в Windows):" << std::endl;
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DUMP_HAS_MMAP 1
+#endif
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define DUMP_X86_SIMD 1
+#endif
+
+// Размер блока чтения
+const size_t DUMP_BLOCK = 1 << 16;
+
+// Первая и последняя строки вывода
+const char* DUMP_PROMPT = "Введите символы (для выхода нажмите Ctrl+D в Linux/macOS или Ctrl+Z в Windows):\n";
+const char* DUMP_FOOTER = "Программа завершена.\n";
+
+// Таблица готовых строк вывода для всех 256 значений байта:
+// "Символ: <байт>, Шестнадцатеричный код: 0xHH, Восьмеричный код: 0<oct>\n"
+struct DumpTable {
+    std::string text;       // Все 256 строк подряд
+    size_t offset[256];     // Начало строки байта в text
+    size_t length[256];     // Длина строки байта
+    size_t maxLength = 0;
+
+    DumpTable() {
+        const char* digits = "0123456789ABCDEF";
+        for (int value = 0; value < 256; ++value) {
+            offset[value] = text.size();
+            text += "Символ: ";
+            text += static_cast<char>(value);
+            text += ", Шестнадцатеричный код: 0x";
+            text += digits[value >> 4];
+            text += digits[value & 15];
+            text += ", Восьмеричный код: 0";
+            // Восьмеричная запись без ведущих нулей, как у std::oct
+            if (value >= 64) {
+                text += static_cast<char>('0' + (value >> 6));
+            }
+            if (value >= 8) {
+                text += static_cast<char>('0' + ((value >> 3) & 7));
+            }
+            text += static_cast<char>('0' + (value & 7));
+            text += '\n';
+            length[value] = text.size() - offset[value];
+            if (length[value] > maxLength) {
+                maxLength = length[value];
+            }
+        }
+    }
+};
+
+const DumpTable& dumpTable() {
+    static const DumpTable table;
+    return table;
+}
+
+// Форматирование n байтов в out через таблицу; возвращает конец записанного
+char* formatDump(const unsigned char* in, size_t n, char* out) {
+    const DumpTable& table = dumpTable();
+    const char* lines = table.text.data();
+    for (size_t i = 0; i < n; ++i) {
+        size_t length = table.length[in[i]];
+        std::memcpy(out, lines + table.offset[in[i]], length);
+        out += length;
+    }
+    return out;
+}
+
+// Чтение того, что уже доступно, но не больше size байтов; 0 - конец ввода,
+// -1 - ошибка чтения (причина в errno). В отличие от fread не ждет заполнения
+// всего буфера, поэтому строка с терминала или из канала обрабатывается сразу,
+// как пришла
+std::ptrdiff_t readAvailable(std::FILE* input, void* buffer, size_t size) {
+#ifdef DUMP_HAS_MMAP
+    for (;;) {
+        ssize_t got = ::read(fileno(input), buffer, size);
+        if (got >= 0) {
+            return got;
+        }
+        if (errno != EINTR) {
+            return -1;
+        }
+    }
+#else
+    size_t got = std::fread(buffer, 1, size, input);
+    if (got == 0 && std::ferror(input)) {
+        errno = errno != 0 ? errno : EIO;
+        return -1;
+    }
+    return static_cast<std::ptrdiff_t>(got);
+#endif
+}
+
+// Быстрый режим: чтение блоками по мере поступления, вывод из таблицы в
+// большой буфер. После каждого блока вывод сбрасывается, так что при вводе с
+// терминала строки появляются сразу после Enter, как и раньше. Возвращает 0
+// или errno ошибки чтения
+int dumpBlocks(std::FILE* input, std::FILE* output) {
+    std::vector<unsigned char> in(DUMP_BLOCK);
+    std::vector<char> out(DUMP_BLOCK * dumpTable().maxLength);
+    std::ptrdiff_t got;
+    while ((got = readAvailable(input, in.data(), in.size())) > 0) {
+        char* end = formatDump(in.data(), static_cast<size_t>(got), out.data());
+        std::fwrite(out.data(), 1, static_cast<size_t>(end - out.data()), output);
+        std::fflush(output);
+    }
+    return got < 0 ? errno : 0;
+}
+
+// Исходный посимвольный вариант на манипуляторах потока (эталон для сравнения)
+void dumpWithStreams() {
     char ch;
     while (std::cin.get(ch)) { // Считываем символ
-        std::cout << "Символ: " << ch 
-                  << ", Шестнадцатеричный код: 0x" << std::hex << std::uppercase << std::setw(2) << std::setfill('0') << (int)(unsigned char)ch 
-                  << ", Восьмеричный код: 0" << std::oct << (int)(unsigned char)ch 
+        std::cout << "Символ: " << ch
+                  << ", Шестнадцатеричный код: 0x" << std::hex << std::uppercase << std::setw(2) << std::setfill('0') << (int)(unsigned char)ch
+                  << ", Восьмеричный код: 0" << std::oct << (int)(unsigned char)ch
                   << std::dec << std::endl; // Возвращаем в десятичный формат для других выводов
     }
+}
+
+#ifdef DUMP_HAS_MMAP
+// ---------- Файловый режим: mmap и параллельное форматирование ----------
+//
+// Каждый байт входа дает строку известной длины, поэтому смещения вывода
+// считаются заранее: сначала потоки параллельно суммируют длины строк своих
+// кусков, затем префиксная сумма дает смещение каждого куска, и потоки пишут
+// куски в выходной файл независимо, без ожидания друг друга. Результат
+// совпадает с "laba4.1 < input > output" побайтно.
+//
+// Вход отображается в память целиком. Выход пишется через pwrite, а не через
+// mmap: вывод в ~100 раз больше входа, и запись в отображенный файл стоит
+// отказа страницы на каждые 4 КБ (на 2 ГБ вывода - в 1.8 раза медленнее pwrite).
+
+const size_t DUMP_CHUNK = 4 << 20; // Кусок входа для одного потока
+
+// Длина вывода для n байтов
+size_t dumpLength(const unsigned char* in, size_t n) {
+    const DumpTable& table = dumpTable();
+    size_t total = 0;
+    for (size_t i = 0; i < n; ++i) {
+        total += table.length[in[i]];
+    }
+    return total;
+}
+
+// Выполняет body(chunk) для всех кусков на threads потоках
+template <typename Body>
+void forEachChunk(size_t chunks, unsigned threads, Body body) {
+    std::atomic<size_t> next(0);
+    auto worker = [&] {
+        for (size_t chunk = next++; chunk < chunks; chunk = next++) {
+            body(chunk);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; ++i) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+}
+
+// Дамп файла inputPath в outputPath; false и сообщение в std::cerr при ошибке
+bool dumpFileMapped(const char* inputPath, const char* outputPath, unsigned threads) {
+    int in = ::open(inputPath, O_RDONLY);
+    if (in < 0) {
+        std::cerr << "Ошибка: не удалось открыть " << inputPath << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (::fstat(in, &info) != 0) {
+        std::cerr << "Ошибка: " << inputPath << ": " << std::strerror(errno) << std::endl;
+        ::close(in);
+        return false;
+    }
+    size_t inputSize = static_cast<size_t>(info.st_size);
+    const unsigned char* input = nullptr;
+    if (inputSize > 0) {
+        void* mapped = ::mmap(nullptr, inputSize, PROT_READ, MAP_PRIVATE, in, 0);
+        if (mapped == MAP_FAILED) {
+            std::cerr << "Ошибка: mmap " << inputPath << ": " << std::strerror(errno) << std::endl;
+            ::close(in);
+            return false;
+        }
+        ::madvise(mapped, inputSize, MADV_SEQUENTIAL);
+        input = static_cast<const unsigned char*>(mapped);
+    }
+
+    // Проход 1: длины вывода кусков и их смещения
+    size_t chunks = (inputSize + DUMP_CHUNK - 1) / DUMP_CHUNK;
+    std::vector<size_t> offsets(chunks + 1, 0);
+    forEachChunk(chunks, threads, [&](size_t chunk) {
+        size_t begin = chunk * DUMP_CHUNK;
+        offsets[chunk + 1] = dumpLength(input + begin, std::min(DUMP_CHUNK, inputSize - begin));
+    });
+    size_t promptLength = std::strlen(DUMP_PROMPT);
+    size_t footerLength = std::strlen(DUMP_FOOTER);
+    offsets[0] = promptLength;
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        offsets[chunk + 1] += offsets[chunk];
+    }
+    size_t outputSize = offsets[chunks] + footerLength;
+
+    // Проход 2: каждый поток форматирует свой кусок блоками в собственный
+    // буфер и пишет его pwrite по заранее известному смещению
+    int out = ::open(outputPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    std::atomic<bool> ok(out >= 0 && ::ftruncate(out, static_cast<off_t>(outputSize)) == 0);
+    auto writeAt = [&](const char* data, size_t size, size_t offset) {
+        while (size > 0) {
+            ssize_t written = ::pwrite(out, data, size, static_cast<off_t>(offset));
+            if (written <= 0) {
+                ok = false;
+                return;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+            offset += static_cast<size_t>(written);
+        }
+    };
+    if (ok) {
+        writeAt(DUMP_PROMPT, promptLength, 0);
+        forEachChunk(chunks, threads, [&](size_t chunk) {
+            static thread_local std::vector<char> buffer(DUMP_BLOCK * dumpTable().maxLength);
+            size_t begin = chunk * DUMP_CHUNK;
+            size_t end = begin + std::min(DUMP_CHUNK, inputSize - begin);
+            size_t offset = offsets[chunk];
+            for (size_t block = begin; block < end && ok; block += DUMP_BLOCK) {
+                char* last = formatDump(input + block, std::min(DUMP_BLOCK, end - block), buffer.data());
+                writeAt(buffer.data(), static_cast<size_t>(last - buffer.data()), offset);
+                offset += static_cast<size_t>(last - buffer.data());
+            }
+        });
+        writeAt(DUMP_FOOTER, footerLength, offsets[chunks]);
+    }
+    if (!ok) {
+        std::cerr << "Ошибка: запись в " << outputPath << ": " << std::strerror(errno) << std::endl;
+    }
+    if (out >= 0 && ::close(out) != 0) {
+        ok = false;
+    }
+    if (input) {
+        ::munmap(const_cast<unsigned char*>(input), inputSize);
+    }
+    ::close(in);
+    return ok;
+}
+
+// Последовательный вариант для сравнения: блочный дамп через stdio
+bool dumpFileSequential(const char* inputPath, const char* outputPath) {
+    std::FILE* input = std::fopen(inputPath, "rb");
+    std::FILE* output = input ? std::fopen(outputPath, "wb") : nullptr;
+    if (!output) {
+        std::cerr << "Ошибка: не удалось открыть " << (input ? outputPath : inputPath) << std::endl;
+        if (input) {
+            std::fclose(input);
+        }
+        return false;
+    }
+    std::fputs(DUMP_PROMPT, output);
+    int readError = dumpBlocks(input, output);
+    if (readError != 0) {
+        std::cerr << "Ошибка чтения " << inputPath << ": " << std::strerror(readError) << std::endl;
+    }
+    std::fputs(DUMP_FOOTER, output);
+    bool ok = readError == 0 && std::ferror(output) == 0;
+    ok = std::fclose(output) == 0 && ok;
+    std::fclose(input);
+    return ok;
+}
+
+// Побайтное сравнение двух файлов
+bool sameFiles(const char* first, const char* second) {
+    std::FILE* a = std::fopen(first, "rb");
+    std::FILE* b = std::fopen(second, "rb");
+    bool same = a && b;
+    std::vector<char> bufferA(DUMP_BLOCK * 16), bufferB(DUMP_BLOCK * 16);
+    while (same) {
+        size_t gotA = std::fread(bufferA.data(), 1, bufferA.size(), a);
+        size_t gotB = std::fread(bufferB.data(), 1, bufferB.size(), b);
+        same = gotA == gotB && std::memcmp(bufferA.data(), bufferB.data(), gotA) == 0;
+        if (gotA == 0) {
+            break;
+        }
+    }
+    if (a) {
+        std::fclose(a);
+    }
+    if (b) {
+        std::fclose(b);
+    }
+    return same;
+}
+
+// laba4.1 --bench-file <input> <output>: последовательный и параллельный режимы
+// на одном файле; второй вывод пишется в <output>.seq
+int benchmarkFileDump(const char* inputPath, const char* outputPath) {
+    std::string sequentialPath = std::string(outputPath) + ".seq";
+    struct stat info;
+    double megabytes = ::stat(inputPath, &info) == 0 ? info.st_size / 1e6 : 0;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // Старые файлы удаляются заранее (усечение большого файла само стоит
+    // заметного времени), а sync не дает отложенной записи одного режима
+    // попасть в замер другого
+    std::remove(outputPath);
+    std::remove(sequentialPath.c_str());
+    ::sync();
+    auto start = std::chrono::steady_clock::now();
+    bool ok = dumpFileSequential(inputPath, sequentialPath.c_str());
+    double sequential = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ::sync();
+    start = std::chrono::steady_clock::now();
+    ok = ok && dumpFileMapped(inputPath, outputPath, threads);
+    double mapped = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!ok) {
+        return 1;
+    }
+    bool same = sameFiles(outputPath, sequentialPath.c_str());
+    std::remove(sequentialPath.c_str());
+
+    std::cout << "Вход " << megabytes << " МБ; последовательно: " << sequential << " с (" << megabytes / sequential
+              << " МБ/с); mmap, потоков " << threads << ": " << mapped << " с (" << megabytes / mapped
+              << " МБ/с); вывод " << (same ? "совпадает" : "РАЗЛИЧАЕТСЯ") << std::endl;
+    return same ? 0 : 1;
+}
+#endif
+
+// ---------- Режим UTF-8: дамп по кодовым точкам ----------
+//
+// laba4.1 --utf8 декодирует ввод как UTF-8 и печатает по строке на кодовую
+// точку со всеми ее байтами:
+//   "Символ: П, Кодовая точка: U+041F, Шестнадцатеричный код: 0xD0 0x9F, Восьмеричный код: 0320 0237"
+// Неверные последовательности (лишние продолжения, обрыв, избыточная запись,
+// суррогаты, значения больше U+10FFFF) печатаются строкой "Ошибка UTF-8" с
+// байтами максимальной неверной части, как при замене на U+FFFD по Unicode.
+//
+// Блок сначала проверяется целиком векторным валидатором (AVX2, алгоритм
+// Кайзера-Лемира, как в simdjson/simdutf; без AVX2 - скалярная проверка).
+// Верный блок декодируется без проверок, а участки из одних ASCII-символов
+// векторно распознаются по 32 байта и выводятся из готовой таблицы строк.
+// Только блок с ошибкой декодируется медленным проверяющим декодером.
+
+// Строки для ASCII-символов в режиме UTF-8
+struct Utf8AsciiTable {
+    std::string line[128];
+
+    Utf8AsciiTable() {
+        const char* digits = "0123456789ABCDEF";
+        for (int value = 0; value < 128; ++value) {
+            std::string& text = line[value];
+            text = "Символ: ";
+            text += static_cast<char>(value);
+            text += ", Кодовая точка: U+00";
+            text += digits[value >> 4];
+            text += digits[value & 15];
+            text += ", Шестнадцатеричный код: 0x";
+            text += digits[value >> 4];
+            text += digits[value & 15];
+            text += ", Восьмеричный код: 0";
+            if (value >= 64) {
+                text += static_cast<char>('0' + (value >> 6));
+            }
+            if (value >= 8) {
+                text += static_cast<char>('0' + ((value >> 3) & 7));
+            }
+            text += static_cast<char>('0' + (value & 7));
+            text += '\n';
+        }
+    }
+};
+
+const Utf8AsciiTable& utf8AsciiTable() {
+    static const Utf8AsciiTable table;
+    return table;
+}
+
+// Длина верной последовательности UTF-8 с начала p (1..4) или 0, если
+// последовательность неверна; тогда invalidLength - длина максимальной неверной части
+size_t decodeUtf8(const unsigned char* p, const unsigned char* end, uint32_t& codePoint, size_t& invalidLength) {
+    unsigned char lead = p[0];
+    if (lead < 0x80) {
+        codePoint = lead;
+        return 1;
+    }
+    size_t length;
+    unsigned char low = 0x80; // Допустимый диапазон второго байта (таблица 3-7 Unicode)
+    unsigned char high = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+        codePoint = lead & 0x1F;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        codePoint = lead & 0x0F;
+        low = lead == 0xE0 ? 0xA0 : 0x80;
+        high = lead == 0xED ? 0x9F : 0xBF;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        codePoint = lead & 0x07;
+        low = lead == 0xF0 ? 0x90 : 0x80;
+        high = lead == 0xF4 ? 0x8F : 0xBF;
+    } else {
+        invalidLength = 1;
+        return 0;
+    }
+    for (size_t i = 1; i < length; ++i) {
+        if (p + i >= end || p[i] < low || p[i] > high) {
+            invalidLength = i;
+            return 0;
+        }
+        codePoint = (codePoint << 6) | (p[i] & 0x3F);
+        low = 0x80;
+        high = 0xBF;
+    }
+    return length;
+}
+
+// Скалярная проверка блока
+bool validateUtf8Scalar(const unsigned char* data, size_t n) {
+    const unsigned char* end = data + n;
+    uint32_t codePoint;
+    size_t invalidLength;
+    for (const unsigned char* p = data; p < end;) {
+        size_t length = decodeUtf8(p, end, codePoint, invalidLength);
+        if (length == 0) {
+            return false;
+        }
+        p += length;
+    }
+    return true;
+}
+
+#ifdef DUMP_X86_SIMD
+// Векторная проверка (AVX2) по 32 байта: каждая пара соседних байтов
+// классифицируется тремя таблицами по 16 элементов (старшая и младшая
+// тетрады предыдущего байта, старшая тетрада текущего); И трех результатов
+// дает биты ошибок. Отдельно проверяется, что 3-й и 4-й байты длинных
+// последовательностей - продолжения
+__attribute__((target("avx2")))
+bool validateUtf8Avx2(const unsigned char* data, size_t n) {
+    const uint8_t TOO_SHORT = 1 << 0;  // Ведущий байт без продолжения
+    const uint8_t TOO_LONG = 1 << 1;   // Продолжение после ASCII
+    const uint8_t OVERLONG_3 = 1 << 2; // 11100000 100_____
+    const uint8_t TOO_LARGE = 1 << 3;  // Больше U+10FFFF
+    const uint8_t SURROGATE = 1 << 4;  // 11101101 101_____
+    const uint8_t OVERLONG_2 = 1 << 5; // 1100000_ 10______
+    const uint8_t TOO_LARGE_1000 = 1 << 6;
+    const uint8_t OVERLONG_4 = 1 << 6; // 11110000 1000____
+    const uint8_t TWO_CONTS = 1 << 7;  // Два продолжения подряд
+    const uint8_t CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+    static const uint8_t byte1HighTable[32] = {
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+        TOO_SHORT | OVERLONG_2, TOO_SHORT, TOO_SHORT | OVERLONG_3 | SURROGATE,
+        TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4,
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+        TOO_SHORT | OVERLONG_2, TOO_SHORT, TOO_SHORT | OVERLONG_3 | SURROGATE,
+        TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4};
+    static const uint8_t byte1LowTable[32] = {
+        CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4, CARRY | OVERLONG_2, CARRY, CARRY,
+        CARRY | TOO_LARGE, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4, CARRY | OVERLONG_2, CARRY, CARRY,
+        CARRY | TOO_LARGE, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000};
+    static const uint8_t byte2HighTable[32] = {
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT};
+    // Таблицы - массивами uint8_t: значения 0x80..0xFF не помещаются в char
+    // аргументов _mm256_setr_epi8
+    const __m256i byte1High = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(byte1HighTable));
+    const __m256i byte1Low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(byte1LowTable));
+    const __m256i byte2High = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(byte2HighTable));
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    // Ведущие байты, после которых в конце куска не хватает продолжений
+    const __m256i maxComplete = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+
+    __m256i previous = _mm256_setzero_si256();
+    __m256i error = _mm256_setzero_si256();
+    __m256i previousIncomplete = _mm256_setzero_si256();
+    unsigned char tail[32];
+    for (size_t i = 0; i < n; i += 32) {
+        __m256i input;
+        if (i + 32 <= n) {
+            input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        } else {
+            // Хвост дополняется нулями (ASCII): обрыв последовательности станет ошибкой
+            std::memset(tail, 0, sizeof(tail));
+            std::memcpy(tail, data + i, n - i);
+            input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tail));
+        }
+        if (_mm256_movemask_epi8(input) == 0) {
+            // Только ASCII: ошибка, лишь если предыдущий кусок оборвался
+            error = _mm256_or_si256(error, previousIncomplete);
+        } else {
+            // Байты, сдвинутые на 1, 2, 3 позиции назад через границу кусков
+            __m256i carried = _mm256_permute2x128_si256(previous, input, 0x21);
+            __m256i prev1 = _mm256_alignr_epi8(input, carried, 16 - 1);
+            __m256i prev2 = _mm256_alignr_epi8(input, carried, 16 - 2);
+            __m256i prev3 = _mm256_alignr_epi8(input, carried, 16 - 3);
+
+            __m256i special = _mm256_and_si256(
+                _mm256_and_si256(
+                    _mm256_shuffle_epi8(byte1High, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+                    _mm256_shuffle_epi8(byte1Low, _mm256_and_si256(prev1, nibble))),
+                _mm256_shuffle_epi8(byte2High, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+            // 3-й байт после 111_____ и 4-й после 1111____ обязаны быть продолжениями
+            __m256i third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+            __m256i fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+            __m256i must23 = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+            error = _mm256_or_si256(error, _mm256_xor_si256(must23, special));
+            previousIncomplete = _mm256_subs_epu8(input, maxComplete);
+        }
+        previous = input;
+    }
+    error = _mm256_or_si256(error, previousIncomplete);
+    return _mm256_testz_si256(error, error) != 0;
+}
+
+// Длина ASCII-префикса (кратно 32 байтам) начиная с p
+__attribute__((target("avx2")))
+size_t asciiPrefixAvx2(const unsigned char* p, const unsigned char* end) {
+    const unsigned char* start = p;
+    while (end - p >= 32 && _mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))) == 0) {
+        p += 32;
+    }
+    return static_cast<size_t>(p - start);
+}
+#endif
+
+// Проверка блока лучшим доступным валидатором
+bool validateUtf8(const unsigned char* data, size_t n) {
+#ifdef DUMP_X86_SIMD
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2) {
+        return validateUtf8Avx2(data, n);
+    }
+#endif
+    return validateUtf8Scalar(data, n);
+}
+
+size_t asciiPrefix(const unsigned char* p, const unsigned char* end) {
+#ifdef DUMP_X86_SIMD
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2) {
+        return asciiPrefixAvx2(p, end);
+    }
+#endif
+    const unsigned char* start = p;
+    while (end - p >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        if (word & 0x8080808080808080ULL) {
+            break;
+        }
+        p += 8;
+    }
+    return static_cast<size_t>(p - start);
+}
+
+// Байты последовательности в шестнадцатеричном и восьмеричном виде
+char* formatUtf8Bytes(const unsigned char* p, size_t n, char* out) {
+    const char* digits = "0123456789ABCDEF";
+    const char* hexLabel = "Шестнадцатеричный код:";
+    out = static_cast<char*>(std::memcpy(out, hexLabel, std::strlen(hexLabel))) + std::strlen(hexLabel);
+    for (size_t i = 0; i < n; ++i) {
+        *out++ = ' ';
+        *out++ = '0';
+        *out++ = 'x';
+        *out++ = digits[p[i] >> 4];
+        *out++ = digits[p[i] & 15];
+    }
+    const char* octLabel = ", Восьмеричный код:";
+    out = static_cast<char*>(std::memcpy(out, octLabel, std::strlen(octLabel))) + std::strlen(octLabel);
+    for (size_t i = 0; i < n; ++i) {
+        *out++ = ' ';
+        *out++ = '0';
+        if (p[i] >= 64) {
+            *out++ = static_cast<char>('0' + (p[i] >> 6));
+        }
+        if (p[i] >= 8) {
+            *out++ = static_cast<char>('0' + ((p[i] >> 3) & 7));
+        }
+        *out++ = static_cast<char>('0' + (p[i] & 7));
+    }
+    *out++ = '\n';
+    return out;
+}
+
+// Самая длинная строка вывода на один байт входа (с запасом)
+const size_t UTF8_LINE_MAX = 192;
+
+// Форматирование блока из целых последовательностей; trusted - блок уже
+// проверен. Возвращает конец записанного, invalid увеличивается на число ошибок
+char* formatUtf8(const unsigned char* p, const unsigned char* end, bool trusted, char* out, size_t& invalid) {
+    const Utf8AsciiTable& table = utf8AsciiTable();
+    const char* digits = "0123456789ABCDEF";
+    while (p < end) {
+        if (*p < 0x80) {
+            size_t run = std::max<size_t>(asciiPrefix(p, end), 1);
+            for (const unsigned char* stop = p + run; p < stop && *p < 0x80; ++p) {
+                const std::string& line = table.line[*p];
+                std::memcpy(out, line.data(), line.size());
+                out += line.size();
+            }
+            continue;
+        }
+        uint32_t codePoint = 0;
+        size_t invalidLength = 0;
+        size_t length;
+        if (trusted) {
+            length = *p >= 0xF0 ? 4 : *p >= 0xE0 ? 3 : 2;
+            codePoint = *p & (0x7F >> length);
+            for (size_t i = 1; i < length; ++i) {
+                codePoint = (codePoint << 6) | (p[i] & 0x3F);
+            }
+        } else {
+            length = decodeUtf8(p, end, codePoint, invalidLength);
+        }
+        if (length == 0) {
+            const char* label = "Ошибка UTF-8: ";
+            out = static_cast<char*>(std::memcpy(out, label, std::strlen(label))) + std::strlen(label);
+            out = formatUtf8Bytes(p, invalidLength, out);
+            p += invalidLength;
+            ++invalid;
+            continue;
+        }
+        const char* label = "Символ: ";
+        out = static_cast<char*>(std::memcpy(out, label, std::strlen(label))) + std::strlen(label);
+        std::memcpy(out, p, length);
+        out += length;
+        const char* pointLabel = ", Кодовая точка: U+";
+        out = static_cast<char*>(std::memcpy(out, pointLabel, std::strlen(pointLabel))) + std::strlen(pointLabel);
+        int shift = codePoint > 0xFFFF ? (codePoint > 0xFFFFF ? 20 : 16) : 12;
+        for (; shift >= 0; shift -= 4) {
+            *out++ = digits[(codePoint >> shift) & 15];
+        }
+        *out++ = ',';
+        *out++ = ' ';
+        out = formatUtf8Bytes(p, length, out);
+        p += length;
+    }
+    return out;
+}
+
+// Сколько байтов в конце данных - начало незавершенной последовательности
+// (их переносят в следующий блок)
+size_t incompleteUtf8Tail(const unsigned char* data, size_t n) {
+    for (size_t back = 1; back <= 3 && back <= n; ++back) {
+        unsigned char byte = data[n - back];
+        if ((byte & 0xC0) != 0x80) {
+            size_t need = byte >= 0xF0 ? 4 : byte >= 0xE0 ? 3 : byte >= 0xC0 ? 2 : 1;
+            return need > back ? back : 0;
+        }
+    }
+    return 0;
+}
+
+// Дамп по кодовым точкам: блоки читаются по мере поступления, оборванная на
+// конце блока последовательность переносится в следующий. Число неверных
+// последовательностей - в invalid; возвращает 0 или errno ошибки чтения
+int dumpUtf8(std::FILE* input, std::FILE* output, size_t& invalid) {
+    std::vector<unsigned char> in(DUMP_BLOCK + 3);
+    std::vector<char> out((DUMP_BLOCK + 3) * UTF8_LINE_MAX);
+    size_t carried = 0;
+    invalid = 0;
+    for (;;) {
+        std::ptrdiff_t result = readAvailable(input, in.data() + carried, DUMP_BLOCK);
+        if (result < 0) {
+            return errno;
+        }
+        size_t got = static_cast<size_t>(result);
+        size_t available = carried + got;
+        if (available == 0) {
+            break;
+        }
+        // На конце ввода оборванная последовательность - ошибка, а не перенос
+        size_t keep = got > 0 ? incompleteUtf8Tail(in.data(), available) : 0;
+        size_t complete = available - keep;
+        bool trusted = validateUtf8(in.data(), complete);
+        char* end = formatUtf8(in.data(), in.data() + complete, trusted, out.data(), invalid);
+        std::fwrite(out.data(), 1, static_cast<size_t>(end - out.data()), output);
+        std::fflush(output);
+        std::memmove(in.data(), in.data() + complete, keep);
+        carried = keep;
+        if (got == 0) {
+            break;
+        }
+    }
+    return 0;
+}
+
+// laba4.1 --bench-utf8 <file>: скорость валидаторов и их согласие с
+// проверяющим декодером на файле и на случайных искажениях
+int benchmarkUtf8(const char* path) {
+    std::FILE* file = std::fopen(path, "rb");
+    if (!file) {
+        std::cerr << "Ошибка: не удалось открыть " << path << std::endl;
+        return 1;
+    }
+    std::vector<unsigned char> data;
+    std::vector<unsigned char> block(DUMP_BLOCK);
+    size_t got;
+    while ((got = std::fread(block.data(), 1, block.size(), file)) > 0) {
+        data.insert(data.end(), block.begin(), block.begin() + got);
+    }
+    std::fclose(file);
+
+    const int rounds = 10;
+    auto measure = [&](bool (*validate)(const unsigned char*, size_t), bool& valid) {
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; ++round) {
+            valid = validate(data.data(), data.size());
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return data.size() * rounds / seconds / 1e6;
+    };
+    bool scalarValid = false;
+    double scalarSpeed = measure(validateUtf8Scalar, scalarValid);
+    std::cout << "Вход " << data.size() << " байт, UTF-8 " << (scalarValid ? "верный" : "неверный")
+              << "; скалярная проверка: " << scalarSpeed << " МБ/с";
+    bool agree = true;
+#ifdef DUMP_X86_SIMD
+    if (__builtin_cpu_supports("avx2")) {
+        bool simdValid = false;
+        double simdSpeed = measure(validateUtf8Avx2, simdValid);
+        std::cout << ", AVX2: " << simdSpeed << " МБ/с";
+        agree = simdValid == scalarValid;
+        // Искажения: случайный байт в случайной позиции короткого окна
+        uint32_t state = 12345;
+        for (int trial = 0; trial < 200000 && agree && !data.empty(); ++trial) {
+            state = state * 1664525u + 1013904223u;
+            size_t begin = state % data.size();
+            size_t length = std::min<size_t>(1 + (state >> 8) % 80, data.size() - begin);
+            std::vector<unsigned char> window(data.begin() + begin, data.begin() + begin + length);
+            state = state * 1664525u + 1013904223u;
+            window[(state >> 8) % length] = static_cast<unsigned char>(state >> 24);
+            agree = validateUtf8Avx2(window.data(), length) == validateUtf8Scalar(window.data(), length);
+        }
+    }
+#endif
+    std::cout << "; результаты " << (agree ? "совпадают" : "РАЗЛИЧАЮТСЯ") << std::endl;
+    return agree ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+#ifdef DUMP_HAS_MMAP
+    // laba4.1 --file <input> <output> - дамп файла в файл на всех ядрах
+    if (argc > 3 && std::strcmp(argv[1], "--file") == 0) {
+        return dumpFileMapped(argv[2], argv[3], std::max(1u, std::thread::hardware_concurrency())) ? 0 : 1;
+    }
+    if (argc > 3 && std::strcmp(argv[1], "--bench-file") == 0) {
+        return benchmarkFileDump(argv[2], argv[3]);
+    }
+#endif
+    if (argc > 2 && std::strcmp(argv[1], "--bench-utf8") == 0) {
+        return benchmarkUtf8(argv[2]);
+    }
+
+    std::cout << DUMP_PROMPT << std::flush;
+
+    // laba4.1 --iostream - исходный посимвольный вывод,
+    // laba4.1 --utf8 - вывод по кодовым точкам UTF-8
+    int readError = 0;
+    if (argc > 1 && std::strcmp(argv[1], "--iostream") == 0) {
+        dumpWithStreams();
+    } else if (argc > 1 && std::strcmp(argv[1], "--utf8") == 0) {
+        size_t invalid = 0;
+        readError = dumpUtf8(stdin, stdout, invalid);
+        if (invalid > 0) {
+            std::cout << "Неверных последовательностей UTF-8: " << invalid << std::endl;
+        }
+    } else {
+        readError = dumpBlocks(stdin, stdout);
+    }
+    if (readError != 0) {
+        std::cerr << "Ошибка чтения ввода: " << std::strerror(readError) << std::endl;
+        return 1;
+    }
 
-    std::cout << "Программа завершена." << std::endl;
+    std::cout << DUMP_FOOTER << std::flush;
     return 0;
 }
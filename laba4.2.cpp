@@ -4,93 +4,1594 @@
 #include <cstdlib>
 #include <ctime>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <cstdint>
+#include <limits>
+#include <charconv>
+#include <sstream>
+#include <chrono>
 
-// Функция для создания входного файла с 100 случайными числами
-void prepareInputFile(const std::string& filename) {
-    std::ofstream outFile(filename);
-    if (!outFile) {
-        std::cerr << "Ошибка при открытии файла для записи: " << filename << std::endl;
-        return;
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define NUMBERS_X86_SIMD 1
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define NUMBERS_HAS_MMAP 1
+#endif
+
+// ---------- Замер стадий (сборка с -DNUMBERS_PROFILE) ----------
+//
+// NUMBERS_STAGE(timer, Stage) заводит в блоке таймер стадии: при выходе из
+// блока время по steady_clock добавляется к итогам стадии, а
+// NUMBERS_STAGE_COUNT(timer, elements, bytes) добавляет обработанные числа и
+// байты (прочитанные и записанные стадией). Без NUMBERS_PROFILE оба макроса
+// пусты и аргументы не вычисляются. Итоги печатаются в cerr при выходе из
+// программы - таблицей или JSON, если задана переменная окружения
+// LABA42_PROFILE=json. Стадии processNumbers выполняются в одном потоке,
+// поэтому итоги не синхронизируются.
+
+#ifdef NUMBERS_PROFILE
+enum class Stage { Parse, Reduce, Transform, Write, Count };
+
+struct StageStats {
+    const char* name;
+    uint64_t nanoseconds;
+    uint64_t elements;
+    uint64_t bytes;
+    uint64_t calls;
+};
+
+StageStats stageStats[static_cast<int>(Stage::Count)] = {
+    {"parse", 0, 0, 0, 0}, {"reduce", 0, 0, 0, 0}, {"transform", 0, 0, 0, 0}, {"write", 0, 0, 0, 0}};
+
+class StageTimer {
+public:
+    explicit StageTimer(Stage stage)
+        : stats(stageStats[static_cast<int>(stage)]), start(std::chrono::steady_clock::now()) {}
+
+    ~StageTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        stats.nanoseconds += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        ++stats.calls;
+    }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+    void count(uint64_t elements, uint64_t bytes) {
+        stats.elements += elements;
+        stats.bytes += bytes;
+    }
+
+private:
+    StageStats& stats;
+    std::chrono::steady_clock::time_point start;
+};
+
+#define NUMBERS_STAGE(timer, stage) StageTimer timer(Stage::stage)
+#define NUMBERS_STAGE_COUNT(timer, elements, bytes) timer.count(elements, bytes)
+
+void resetStageStats() {
+    for (StageStats& stats : stageStats) {
+        stats.nanoseconds = stats.elements = stats.bytes = stats.calls = 0;
+    }
+}
+
+// Итоги стадий: время, числа, байты, МБ/с и нс на число
+void printStageReport(std::ostream& out, bool json) {
+    char line[160];
+    if (!json) {
+        std::snprintf(line, sizeof(line), "%-10s %8s %12s %14s %10s %10s\n", "stage", "ms", "elements", "bytes", "MB/s",
+                      "ns/elem");
+        out << line;
+    } else {
+        out << "{\"stages\": [";
     }
-    
-    std::srand(std::time(nullptr)); // Инициализация генератора случайных чисел
-    for (int i = 0; i < 100; ++i) {
-        int randomNumber = std::rand() % 101 - 50; // Генерация числа в диапазоне [-50, 50]
-        outFile << randomNumber << '\n';
+    bool first = true;
+    for (const StageStats& stats : stageStats) {
+        if (stats.calls == 0) {
+            continue;
+        }
+        double megabytesPerSecond = stats.nanoseconds ? stats.bytes * 1e3 / stats.nanoseconds : 0;
+        double nanosecondsPerElement = stats.elements ? static_cast<double>(stats.nanoseconds) / stats.elements : 0;
+        if (json) {
+            std::snprintf(line, sizeof(line),
+                          "%s{\"name\": \"%s\", \"ns\": %llu, \"elements\": %llu, \"bytes\": %llu, \"mb_per_s\": %.1f, "
+                          "\"ns_per_element\": %.2f}",
+                          first ? "" : ", ", stats.name, static_cast<unsigned long long>(stats.nanoseconds),
+                          static_cast<unsigned long long>(stats.elements), static_cast<unsigned long long>(stats.bytes),
+                          megabytesPerSecond, nanosecondsPerElement);
+        } else {
+            std::snprintf(line, sizeof(line), "%-10s %8.2f %12llu %14llu %10.1f %10.2f\n", stats.name,
+                          stats.nanoseconds / 1e6, static_cast<unsigned long long>(stats.elements),
+                          static_cast<unsigned long long>(stats.bytes), megabytesPerSecond, nanosecondsPerElement);
+        }
+        out << line;
+        first = false;
+    }
+    if (json) {
+        out << "]}\n";
+    }
+}
+
+// Печать итогов при выходе из программы, если какая-то стадия выполнялась
+struct StageReportAtExit {
+    ~StageReportAtExit() {
+        for (const StageStats& stats : stageStats) {
+            if (stats.calls > 0) {
+                const char* format = std::getenv("LABA42_PROFILE");
+                printStageReport(std::cerr, format && std::strcmp(format, "json") == 0);
+                return;
+            }
+        }
+    }
+} stageReportAtExit;
+#else
+#define NUMBERS_STAGE(timer, stage) ((void)0)
+#define NUMBERS_STAGE_COUNT(timer, elements, bytes) ((void)0)
+#endif
+
+// ---------- Быстрый ввод-вывод чисел ----------
+//
+// Чтение и запись идут блоками по 1 МБ через std::from_chars/std::to_chars
+// (без локалей и виртуальных вызовов iostream). Текст тот же, что у
+// inFile >> number и outFile << number: числа разделяются любыми пробельными
+// символами, допускаются знак + и ведущие нули, чтение прекращается на первом
+// слове, которое не читается как int (в том числе при переполнении), а числа
+// пишутся как у потока по умолчанию - %g с 6 значащими цифрами. Кратчайшая
+// точная запись (to_chars без точности) дала бы другой текст, поэтому не используется.
+
+// Пробельный символ в смысле operator>>: ' ', '\t', '\n', '\v', '\f', '\r'
+inline bool isNumberSpace(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// Пропуск пробельных символов; длинные серии - по 16 байт за шаг (SSE2)
+inline const char* skipNumberSpaces(const char* p, const char* end) {
+    if (p == end || !isNumberSpace(*p)) {
+        return p;
+    }
+#ifdef __SSE2__
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i four = _mm_set1_epi8(4);
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i control = _mm_sub_epi8(chunk, tab); // '\t'..'\r' -> 0..4
+        __m128i isSpace = _mm_or_si128(_mm_cmpeq_epi8(chunk, space),
+                                       _mm_cmpeq_epi8(_mm_min_epu8(control, four), control));
+        unsigned other = ~static_cast<unsigned>(_mm_movemask_epi8(isSpace)) & 0xFFFF;
+        if (other != 0) {
+            return p + __builtin_ctz(other);
+        }
+        p += 16;
+    }
+#endif
+    while (p < end && isNumberSpace(*p)) {
+        ++p;
     }
+    return p;
+}
 
-    outFile.close();
+// Результат разбора очередного числа
+enum class ParseStatus {
+    Ok,      // Число прочитано
+    Stop,    // Конец данных или слово, которое operator>> не прочитал бы
+    NeedMore // Число (или пробелы) доходит до конца буфера, а файл не кончился
+};
+
+// Разбор следующего числа из [p, end); при Ok и NeedMore p сдвигается за
+// прочитанное. atEof - за end данных больше нет
+inline ParseStatus parseNextNumber(const char*& p, const char* end, bool atEof, int& value) {
+    const char* start = skipNumberSpaces(p, end);
+    p = start;
+    const char* digits = start;
+    if (digits < end && (*digits == '+' || *digits == '-')) {
+        ++digits;
+    }
+    if (digits == end) {
+        return atEof ? ParseStatus::Stop : ParseStatus::NeedMore;
+    }
+    if (*digits < '0' || *digits > '9') {
+        return ParseStatus::Stop; // В том числе "+-5": from_chars знак '+' не принимает
+    }
+    std::from_chars_result parsed = std::from_chars(*start == '+' ? digits : start, end, value);
+    if (parsed.ptr == end && !atEof) {
+        return ParseStatus::NeedMore;
+    }
+    if (parsed.ec != std::errc()) {
+        return ParseStatus::Stop; // Переполнение int
+    }
+    p = parsed.ptr;
+    return ParseStatus::Ok;
 }
 
+// Чтение чисел из файла блоками
+class NumberReader {
+public:
+    explicit NumberReader(const std::string& filename)
+        : file(std::fopen(filename.c_str(), "r")), buffer(1 << 20), pos(0), end(0), eof(false), total(0) {}
+
+    ~NumberReader() {
+        if (file) {
+            std::fclose(file);
+        }
+    }
+
+    NumberReader(const NumberReader&) = delete;
+    NumberReader& operator=(const NumberReader&) = delete;
+
+    bool isOpen() const { return file != nullptr; }
+
+    // Прочитано байт из файла
+    uint64_t bytesRead() const { return total; }
+
+    // Следующее число; false - конец файла или слово, которое не читается как int
+    bool next(int& value) {
+        for (;;) {
+            const char* p = buffer.data() + pos;
+            ParseStatus status = parseNextNumber(p, buffer.data() + end, eof, value);
+            pos = static_cast<size_t>(p - buffer.data());
+            if (status != ParseStatus::NeedMore) {
+                return status == ParseStatus::Ok;
+            }
+            refill();
+        }
+    }
+
+private:
+    std::FILE* file;
+    std::vector<char> buffer;
+    size_t pos;
+    size_t end;
+    bool eof;
+    uint64_t total;
+
+    // Непрочитанный остаток - в начало буфера, дальше - следующий блок файла.
+    // Буфер растет, только если одно слово длиннее его
+    void refill() {
+        std::memmove(buffer.data(), buffer.data() + pos, end - pos);
+        end -= pos;
+        pos = 0;
+        if (end == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+        size_t got = file ? std::fread(buffer.data() + end, 1, buffer.size() - end, file) : 0;
+        end += got;
+        total += got;
+        eof = got == 0;
+    }
+};
+
+// Запись чисел в файл через буфер
+class NumberWriter {
+public:
+    explicit NumberWriter(const std::string& filename)
+        : file(std::fopen(filename.c_str(), "w")), buffer(1 << 20), used(0), written(0), failed(file == nullptr) {}
+
+    ~NumberWriter() {
+        close();
+    }
+
+    NumberWriter(const NumberWriter&) = delete;
+    NumberWriter& operator=(const NumberWriter&) = delete;
+
+    bool isOpen() const { return file != nullptr; }
+
+    // Записано байт, включая еще не сброшенные в файл
+    uint64_t bytesWritten() const { return written + used; }
+
+    // Число и перевод строки, как outFile << number << '\n'
+    void write(double number) {
+        if (buffer.size() - used < 32) {
+            flush();
+        }
+        char* out = buffer.data() + used;
+        out = std::to_chars(out, out + 31, number, std::chars_format::general, 6).ptr;
+        *out++ = '\n';
+        used = static_cast<size_t>(out - buffer.data());
+    }
+
+    // Целое число и перевод строки
+    void write(int number) {
+        if (buffer.size() - used < 32) {
+            flush();
+        }
+        char* out = buffer.data() + used;
+        out = std::to_chars(out, out + 31, number).ptr;
+        *out++ = '\n';
+        used = static_cast<size_t>(out - buffer.data());
+    }
+
+    // Дописывает буфер и закрывает файл; false - ошибка записи
+    bool close() {
+        if (file) {
+            flush();
+            failed = std::fclose(file) != 0 || failed;
+            file = nullptr;
+        }
+        return !failed;
+    }
+
+private:
+    std::FILE* file;
+    std::vector<char> buffer;
+    size_t used;
+    uint64_t written;
+    bool failed;
+
+    void flush() {
+        if (used > 0 && std::fwrite(buffer.data(), 1, used, file) != used) {
+            failed = true;
+        }
+        written += used;
+        used = 0;
+    }
+};
+
 // Функция для чтения чисел из файла
 std::vector<int> readNumbersFromFile(const std::string& filename) {
-    std::ifstream inFile(filename);
-    if (!inFile) {
+    NumberReader reader(filename);
+    if (!reader.isOpen()) {
         std::cerr << "Ошибка при открытии файла для чтения: " << filename << std::endl;
         return {};
     }
 
+    NUMBERS_STAGE(timer, Parse);
     std::vector<int> numbers;
     int number;
-    while (inFile >> number) {
+    while (reader.next(number)) {
         numbers.push_back(number);
     }
-
-    inFile.close();
+    NUMBERS_STAGE_COUNT(timer, numbers.size(), reader.bytesRead());
     return numbers;
 }
 
 // Функция для записи преобразованных чисел в выходной файл
 void writeNumbersToFile(const std::string& filename, const std::vector<double>& numbers) {
-    std::ofstream outFile(filename);
-    if (!outFile) {
+    NumberWriter writer(filename);
+    if (!writer.isOpen()) {
         std::cerr << "Ошибка при открытии файла для записи: " << filename << std::endl;
         return;
     }
 
+    NUMBERS_STAGE(timer, Write);
     for (double number : numbers) {
-        outFile << number << '\n';
+        writer.write(number);
+    }
+    if (!writer.close()) {
+        std::cerr << "Ошибка при записи в файл: " << filename << std::endl;
+    }
+    NUMBERS_STAGE_COUNT(timer, numbers.size(), writer.bytesWritten());
+}
+
+// ---------- Векторные ядра processNumbers ----------
+//
+// Два цикла processNumbers над непрерывным массивом int32: сумма модулей и
+// преобразование нечётных. Сумма копится в int64 точно, поэтому не зависит
+// от порядка сложения и совпадает с исходной суммой в double, пока та
+// меньше 2^53. std::abs(INT_MIN) в int остаётся INT_MIN, как и у
+// векторного abs, - результат совпадает и для этого числа. Нечётность по
+// модулю - это младший бит числа, выбор между n / average и n делается без
+// ветвлений через маску.
+
+// Ядро суммы модулей
+using AbsSumKernel = int64_t (*)(const int* numbers, size_t n);
+// Ядро преобразования: out[i] = нечётное ? numbers[i] / average : numbers[i]
+using TransformKernel = void (*)(const int* numbers, size_t n, double average, double* out);
+
+int64_t absSumScalar(const int* numbers, size_t n) {
+    int64_t sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += std::abs(numbers[i]);
+    }
+    return sum;
+}
+
+void transformScalar(const int* numbers, size_t n, double average, double* out) {
+    for (size_t i = 0; i < n; ++i) {
+        double value = numbers[i];
+        out[i] = numbers[i] & 1 ? value / average : value;
+    }
+}
+
+#ifdef NUMBERS_X86_SIMD
+__attribute__((target("sse4.1")))
+int64_t absSumSse4(const int* numbers, size_t n) {
+    __m128i low = _mm_setzero_si128();
+    __m128i high = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i a = _mm_abs_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(numbers + i)));
+        low = _mm_add_epi64(low, _mm_cvtepi32_epi64(a));
+        high = _mm_add_epi64(high, _mm_cvtepi32_epi64(_mm_srli_si128(a, 8)));
+    }
+    // Сложение дорожек через память: _mm_extract_epi64 есть только на x86-64
+    int64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), _mm_add_epi64(low, high));
+    int64_t sum = lanes[0] + lanes[1];
+    return sum + absSumScalar(numbers + i, n - i);
+}
+
+__attribute__((target("sse4.1")))
+void transformSse4(const int* numbers, size_t n, double average, double* out) {
+    const __m128d divisor = _mm_set1_pd(average);
+    const __m128i one = _mm_set1_epi32(1);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i a = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(numbers + i));
+        __m128d value = _mm_cvtepi32_pd(a);
+        __m128d odd = _mm_castsi128_pd(_mm_cvtepi32_epi64(_mm_cmpeq_epi32(_mm_and_si128(a, one), one)));
+        _mm_storeu_pd(out + i, _mm_blendv_pd(value, _mm_div_pd(value, divisor), odd));
+    }
+    transformScalar(numbers + i, n - i, average, out + i);
+}
+
+__attribute__((target("avx2")))
+int64_t absSumAvx2(const int* numbers, size_t n) {
+    __m256i low = _mm256_setzero_si256();
+    __m256i high = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i a = _mm256_abs_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(numbers + i)));
+        low = _mm256_add_epi64(low, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(a)));
+        high = _mm256_add_epi64(high, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(a, 1)));
+    }
+    __m256i total = _mm256_add_epi64(low, high);
+    __m128i half = _mm_add_epi64(_mm256_castsi256_si128(total), _mm256_extracti128_si256(total, 1));
+    int64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), half);
+    int64_t sum = lanes[0] + lanes[1];
+    return sum + absSumScalar(numbers + i, n - i);
+}
+
+__attribute__((target("avx2")))
+void transformAvx2(const int* numbers, size_t n, double average, double* out) {
+    const __m256d divisor = _mm256_set1_pd(average);
+    const __m128i one = _mm_set1_epi32(1);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(numbers + i));
+        __m256d value = _mm256_cvtepi32_pd(a);
+        __m256d odd = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(_mm_cmpeq_epi32(_mm_and_si128(a, one), one)));
+        _mm256_storeu_pd(out + i, _mm256_blendv_pd(value, _mm256_div_pd(value, divisor), odd));
+    }
+    transformScalar(numbers + i, n - i, average, out + i);
+}
+#endif
+
+// Набор ядер одного уровня
+struct NumberKernels {
+    const char* name;
+    AbsSumKernel absSum;
+    TransformKernel transform;
+};
+
+// Доступные на этом процессоре ядра, от простого к лучшему
+std::vector<NumberKernels> availableNumberKernels() {
+    std::vector<NumberKernels> kernels{{"scalar", absSumScalar, transformScalar}};
+#ifdef NUMBERS_X86_SIMD
+    if (__builtin_cpu_supports("sse4.1")) {
+        kernels.push_back({"sse4", absSumSse4, transformSse4});
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.push_back({"avx2", absSumAvx2, transformAvx2});
+    }
+#endif
+    return kernels;
+}
+
+// Лучшие ядра, выбранные при первом вызове
+const NumberKernels& numberKernels() {
+    static const NumberKernels kernels = availableNumberKernels().back();
+    return kernels;
+}
+
+// Точная сумма модулей для среднего. Генератор допускает 1e10 чисел около
+// INT32_MAX, а это больше 2^63, поэтому int64_t здесь переполняется. Сумма
+// копится в 128 битах; все пути обработки складывают одинаково, поэтому
+// среднее у них совпадает бит в бит
+class AbsSum {
+public:
+    void add(int64_t value) {
+#ifdef __SIZEOF_INT128__
+        total += value;
+#else
+        uint64_t before = low;
+        low += static_cast<uint64_t>(value);
+        high += (value < 0 ? -1 : 0) + (low < before ? 1 : 0);
+#endif
     }
 
-    outFile.close();
+    double toDouble() const {
+#ifdef __SIZEOF_INT128__
+        return static_cast<double>(total);
+#else
+        return std::ldexp(static_cast<double>(high), 64) + static_cast<double>(low);
+#endif
+    }
+
+private:
+#ifdef __SIZEOF_INT128__
+    __extension__ __int128 total = 0;
+#else
+    uint64_t low = 0;
+    int64_t high = 0;
+#endif
+};
+
+// Ядро absSum копит в int64_t: 2^30 чисел по модулю до 2^31 в нем помещаются
+const size_t ABS_SUM_BLOCK = size_t(1) << 30;
+
+// Среднее и преобразование над непрерывным массивом чисел (вектор или
+// отображенный в память двоичный файл); false - нет данных или среднее равно 0
+bool transformNumbers(const int* numbers, size_t count, std::vector<double>& transformedNumbers) {
+    if (count == 0) {
+        std::cerr << "Нет данных для обработки." << std::endl;
+        return false;
+    }
+
+    // Вычисление среднего арифметического всех чисел
+    const NumberKernels& kernels = numberKernels();
+    AbsSum sum;
+    {
+        NUMBERS_STAGE(timer, Reduce);
+        for (size_t i = 0; i < count; i += ABS_SUM_BLOCK) {
+            sum.add(kernels.absSum(numbers + i, std::min(ABS_SUM_BLOCK, count - i)));
+        }
+        NUMBERS_STAGE_COUNT(timer, count, count * sizeof(int));
+    }
+    double average = sum.toDouble() / count;
+
+    if (average == 0) {
+        std::cerr << "Среднее арифметическое равно 0, деление невозможно." << std::endl;
+        return false;
+    }
+
+    // Преобразование чисел: нечетные по модулю делятся на среднее, четные остаются без изменений
+    NUMBERS_STAGE(timer, Transform);
+    transformedNumbers.resize(count);
+    kernels.transform(numbers, count, average, transformedNumbers.data());
+    NUMBERS_STAGE_COUNT(timer, count, count * (sizeof(int) + sizeof(double)));
+    return true;
 }
 
 // Основная функция для преобразования чисел
 void processNumbers(const std::string& inputFilename, const std::string& outputFilename) {
     // Чтение чисел из входного файла
     std::vector<int> numbers = readNumbersFromFile(inputFilename);
-    if (numbers.empty()) {
-        std::cerr << "Нет данных для обработки." << std::endl;
+
+    std::vector<double> transformedNumbers;
+    if (!transformNumbers(numbers.data(), numbers.size(), transformedNumbers)) {
         return;
     }
 
-    // Вычисление среднего арифметического всех чисел
-    double sum = 0;
-    for (int number : numbers) {
-        sum += std::abs(number);
+    // Запись преобразованных чисел в выходной файл
+    writeNumbersToFile(outputFilename, transformedNumbers);
+}
+
+// Потоковый вариант processNumbers для файлов любого размера: два прохода по
+// файлу без хранения чисел в памяти. Проход 1 считает сумму модулей и
+// количество, проход 2 преобразует числа и сразу пишет их в выходной файл.
+// Результат совпадает с processNumbers; false - ошибка или нет данных
+bool processNumbersStreaming(const std::string& inputFilename, const std::string& outputFilename) {
+    // Проход 1: сумма модулей и количество
+    AbsSum sum;
+    size_t count = 0;
+    {
+        NumberReader reader(inputFilename);
+        if (!reader.isOpen()) {
+            std::cerr << "Ошибка при открытии файла для чтения: " << inputFilename << std::endl;
+            return false;
+        }
+        int number;
+        while (reader.next(number)) {
+            sum.add(std::abs(number));
+            ++count;
+        }
+    }
+    if (count == 0) {
+        std::cerr << "Нет данных для обработки." << std::endl;
+        return false;
+    }
+    double average = sum.toDouble() / count;
+    if (average == 0) {
+        std::cerr << "Среднее арифметическое равно 0, деление невозможно." << std::endl;
+        return false;
+    }
+
+    // Проход 2: преобразование и запись тех же count чисел
+    NumberReader reader(inputFilename);
+    NumberWriter writer(outputFilename);
+    if (!reader.isOpen() || !writer.isOpen()) {
+        std::cerr << "Ошибка при открытии файла для записи: " << outputFilename << std::endl;
+        return false;
+    }
+    int number;
+    for (size_t i = 0; i < count && reader.next(number); ++i) {
+        if (std::abs(number) % 2 == 1) { // Проверка на нечетность по модулю
+            writer.write(number / average);
+        } else {
+            writer.write(static_cast<double>(number)); // Четные остаются без изменений, но пишутся как double
+        }
+    }
+    return writer.close();
+}
+
+// ---------- Многопоточная запись по кускам ----------
+
+const size_t PARALLEL_SLOTS_PER_THREAD = 2;
+
+// Буфер вывода куска
+struct ChunkOutput {
+    enum State { Free, Busy, Ready };
+    State state = Free;
+    size_t chunk = 0;
+    std::vector<char> text;
+    size_t used = 0;
+};
+
+// Выполняет body(i) для i из [0, n) на threads потоках
+template <typename Body>
+void parallelFor(size_t n, unsigned threads, Body body) {
+    std::atomic<size_t> next(0);
+    auto worker = [&] {
+        for (size_t i = next++; i < n; i = next++) {
+            body(i);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+}
+
+// Куски 0..chunks-1 готовятся параллельно: fill(i, buffer) заполняет буфер
+// куска и возвращает число байт, а sink(data, size) на вызывающем потоке
+// получает готовые куски строго по порядку. В работе не больше
+// PARALLEL_SLOTS_PER_THREAD буферов на поток, поэтому память не зависит от
+// числа кусков. false - sink сообщил об ошибке
+template <typename Fill, typename Sink>
+bool writeChunksInOrder(size_t chunks, unsigned threads, Fill fill, Sink sink) {
+    std::vector<ChunkOutput> slots(threads * PARALLEL_SLOTS_PER_THREAD);
+    std::mutex mutex;
+    std::condition_variable slotFreed;
+    std::condition_variable slotReady;
+    std::thread producer([&] {
+        parallelFor(chunks, threads, [&](size_t i) {
+            ChunkOutput& slot = slots[i % slots.size()];
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                slotFreed.wait(lock, [&] { return slot.state == ChunkOutput::Free; });
+                slot.state = ChunkOutput::Busy;
+            }
+            size_t used = fill(i, slot.text);
+            std::lock_guard<std::mutex> lock(mutex);
+            slot.used = used;
+            slot.chunk = i;
+            slot.state = ChunkOutput::Ready;
+            slotReady.notify_all();
+        });
+    });
+
+    bool ok = true;
+    for (size_t i = 0; i < chunks; ++i) {
+        ChunkOutput& slot = slots[i % slots.size()];
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            slotReady.wait(lock, [&] { return slot.state == ChunkOutput::Ready && slot.chunk == i; });
+        }
+        ok = sink(slot.text.data(), slot.used) && ok;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            slot.state = ChunkOutput::Free;
+        }
+        slotFreed.notify_all();
+    }
+    producer.join();
+    return ok;
+}
+
+#ifdef NUMBERS_HAS_MMAP
+// ---------- Параллельный режим (laba4.2 --parallel) ----------
+//
+// Файл отображается в память и делится на куски по ~4 МБ по границам
+// пробельных символов (число никогда не разрезается). Проход 1: потоки
+// разбирают куски и считают сумму модулей в целых числах - точно и
+// независимо от порядка сложения; кусок, где встретилось нечитаемое слово,
+// становится последним (как остановка operator>>). Проход 2: потоки заново
+// разбирают свои куски, преобразуют и форматируют числа в буфер куска, а
+// главный поток пишет готовые буферы по порядку (writeChunksInOrder), поэтому
+// память не зависит от размера файла. Вывод совпадает с processNumbers, пока сумма модулей меньше
+// 2^53 (дальше последовательная сумма в double уже неточна).
+
+const size_t PARALLEL_CHUNK = 4 << 20;
+
+// Кусок входа и итоги его первого прохода
+struct NumberChunk {
+    const char* begin;
+    const char* end;
+    size_t count = 0;       // Прочитано чисел
+    int64_t absSum = 0;     // Сумма std::abs(int), как в processNumbers (abs(INT_MIN) остаётся отрицательным);
+                            // в куске не больше PARALLEL_CHUNK / 2 чисел, int64_t хватает
+    bool stopped = false;   // Разбор остановился на нечитаемом слове
+};
+
+// Деление [data, data + size) на куски, заканчивающиеся после пробельного символа
+std::vector<NumberChunk> splitNumberChunks(const char* data, size_t size) {
+    std::vector<NumberChunk> chunks;
+    const char* end = data + size;
+    for (const char* begin = data; begin < end;) {
+        const char* stop = end - begin > static_cast<std::ptrdiff_t>(PARALLEL_CHUNK) ? begin + PARALLEL_CHUNK : end;
+        while (stop < end && !isNumberSpace(stop[-1])) {
+            ++stop;
+        }
+        NumberChunk chunk;
+        chunk.begin = begin;
+        chunk.end = stop;
+        chunks.push_back(chunk);
+        begin = stop;
     }
-    double average = sum / numbers.size();
+    return chunks;
+}
 
+bool processNumbersParallel(const std::string& inputFilename, const std::string& outputFilename, unsigned threads) {
+    int fd = ::open(inputFilename.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || ::fstat(fd, &info) != 0) {
+        std::cerr << "Ошибка при открытии файла для чтения: " << inputFilename << std::endl;
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapped = size > 0 ? ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : nullptr;
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Ошибка при отображении файла: " << inputFilename << std::endl;
+        return false;
+    }
+    const char* data = static_cast<const char*>(mapped);
+    struct Unmap {
+        void* address;
+        size_t size;
+        ~Unmap() {
+            if (address) {
+                ::munmap(address, size);
+            }
+        }
+    } unmap{mapped, size};
+
+    // Проход 1: количество и сумма модулей по кускам
+    std::vector<NumberChunk> chunks = splitNumberChunks(data, size);
+    parallelFor(chunks.size(), threads, [&](size_t i) {
+        NumberChunk& chunk = chunks[i];
+        const char* p = chunk.begin;
+        int number;
+        ParseStatus status;
+        while ((status = parseNextNumber(p, chunk.end, true, number)) == ParseStatus::Ok) {
+            chunk.absSum += std::abs(number);
+            ++chunk.count;
+        }
+        chunk.stopped = p != chunk.end;
+    });
+    size_t used = 0;
+    size_t count = 0;
+    AbsSum sum;
+    for (; used < chunks.size(); ++used) {
+        count += chunks[used].count;
+        sum.add(chunks[used].absSum);
+        if (chunks[used].stopped) {
+            ++used;
+            break;
+        }
+    }
+    if (count == 0) {
+        std::cerr << "Нет данных для обработки." << std::endl;
+        return false;
+    }
+    double average = sum.toDouble() / count;
     if (average == 0) {
         std::cerr << "Среднее арифметическое равно 0, деление невозможно." << std::endl;
-        return;
+        return false;
+    }
+
+    // Проход 2: преобразование и форматирование по кускам, запись по порядку
+    std::FILE* output = std::fopen(outputFilename.c_str(), "w");
+    if (!output) {
+        std::cerr << "Ошибка при открытии файла для записи: " << outputFilename << std::endl;
+        return false;
+    }
+    bool ok = writeChunksInOrder(
+        used, threads,
+        [&](size_t i, std::vector<char>& text) {
+            const NumberChunk& chunk = chunks[i];
+            // Каждое число - не больше 12 байт текста на входе и 14 на выходе
+            text.resize(std::max(text.size(), chunk.count * 16 + 16));
+            char* out = text.data();
+            const char* p = chunk.begin;
+            int number;
+            for (size_t k = 0; k < chunk.count && parseNextNumber(p, chunk.end, true, number) == ParseStatus::Ok; ++k) {
+                double value = std::abs(number) % 2 == 1 ? number / average : static_cast<double>(number);
+                out = std::to_chars(out, out + 15, value, std::chars_format::general, 6).ptr;
+                *out++ = '\n';
+            }
+            return static_cast<size_t>(out - text.data());
+        },
+        [&](const char* text, size_t length) { return std::fwrite(text, 1, length, output) == length; });
+    ok = std::fclose(output) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Ошибка при записи в файл: " << outputFilename << std::endl;
+    }
+    return ok;
+}
+#endif
+
+// ---------- Двоичный формат (laba4.2 --binary, --to-binary, --to-text) ----------
+//
+// Файл - заголовок BinaryNumberHeader и сразу за ним count чисел одного типа
+// в little-endian: int32 на входе, float64 на выходе. Заголовок занимает 24
+// байта, поэтому данные выровнены и читаются прямо из отображения файла в
+// память, без копирования. Контрольная сумма - FNV-1a по 32-битным словам
+// данных: быстрее побайтовой, а размер данных всегда кратен 4.
+
+const char BINARY_NUMBERS_MAGIC[4] = {'L', '4', '2', 'N'};
+
+enum class BinaryElementType : uint32_t { Int32 = 1, Float64 = 2 };
+
+struct BinaryNumberHeader {
+    char magic[4];
+    uint32_t elementType; // BinaryElementType
+    uint64_t count;
+    uint64_t checksum;
+};
+static_assert(sizeof(BinaryNumberHeader) == 24, "заголовок двоичного файла - 24 байта");
+
+size_t binaryElementSize(uint32_t type) {
+    return type == static_cast<uint32_t>(BinaryElementType::Int32)     ? sizeof(int32_t)
+           : type == static_cast<uint32_t>(BinaryElementType::Float64) ? sizeof(double)
+                                                                       : 0;
+}
+
+// Формат хранит числа в little-endian и читается без преобразований
+bool hostIsLittleEndian() {
+    const uint16_t probe = 1;
+    unsigned char first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+// Накопление контрольной суммы; size кратен 4
+uint64_t binaryChecksum(const void* data, size_t size, uint64_t hash = 14695981039346656037ull) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i + 4 <= size; i += 4) {
+        uint32_t word;
+        std::memcpy(&word, bytes + i, 4);
+        hash = (hash ^ word) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// Последовательная запись двоичного файла; заголовок дописывается в close()
+class BinaryNumberWriter {
+public:
+    BinaryNumberWriter(const std::string& filename, BinaryElementType type)
+        : file(std::fopen(filename.c_str(), "wb")), failed(file == nullptr), header() {
+        std::memcpy(header.magic, BINARY_NUMBERS_MAGIC, sizeof(header.magic));
+        header.elementType = static_cast<uint32_t>(type);
+        header.checksum = binaryChecksum(nullptr, 0);
+        if (file) {
+            failed = std::fwrite(&header, sizeof(header), 1, file) != 1;
+        }
+    }
+
+    ~BinaryNumberWriter() {
+        close();
+    }
+
+    BinaryNumberWriter(const BinaryNumberWriter&) = delete;
+    BinaryNumberWriter& operator=(const BinaryNumberWriter&) = delete;
+
+    bool isOpen() const { return file != nullptr; }
+
+    // count чисел типа, указанного в конструкторе
+    void append(const void* data, size_t count) {
+        size_t bytes = count * binaryElementSize(header.elementType);
+        header.count += count;
+        header.checksum = binaryChecksum(data, bytes, header.checksum);
+        if (file && std::fwrite(data, 1, bytes, file) != bytes) {
+            failed = true;
+        }
+    }
+
+    // Записывает итоговый заголовок и закрывает файл; false - ошибка записи
+    bool close() {
+        if (file) {
+            failed = std::fseek(file, 0, SEEK_SET) != 0 || std::fwrite(&header, sizeof(header), 1, file) != 1 || failed;
+            failed = std::fclose(file) != 0 || failed;
+            file = nullptr;
+        }
+        return !failed;
+    }
+
+private:
+    std::FILE* file;
+    bool failed;
+    BinaryNumberHeader header;
+};
+
+#ifdef NUMBERS_HAS_MMAP
+// Двоичный файл, отображенный в память только для чтения
+class MappedNumberFile {
+public:
+    MappedNumberFile() : address(nullptr), size(0), header() {}
+
+    ~MappedNumberFile() {
+        if (address) {
+            ::munmap(address, size);
+        }
+    }
+
+    MappedNumberFile(const MappedNumberFile&) = delete;
+    MappedNumberFile& operator=(const MappedNumberFile&) = delete;
+
+    // Отображение и проверка заголовка, размера и контрольной суммы; false - сообщение в cerr
+    bool open(const std::string& filename) {
+        if (!hostIsLittleEndian()) {
+            std::cerr << "Двоичный формат поддерживается только на little-endian процессорах." << std::endl;
+            return false;
+        }
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        struct stat info;
+        if (fd < 0 || ::fstat(fd, &info) != 0) {
+            std::cerr << "Ошибка при открытии файла для чтения: " << filename << std::endl;
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            return false;
+        }
+        size = static_cast<size_t>(info.st_size);
+        if (size < sizeof(BinaryNumberHeader)) {
+            ::close(fd);
+            std::cerr << "Файл слишком короткий для двоичного формата: " << filename << std::endl;
+            return false;
+        }
+        void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            std::cerr << "Ошибка при отображении файла: " << filename << std::endl;
+            return false;
+        }
+        address = mapped;
+        std::memcpy(&header, address, sizeof(header));
+
+        size_t elementSize = binaryElementSize(header.elementType);
+        if (std::memcmp(header.magic, BINARY_NUMBERS_MAGIC, sizeof(header.magic)) != 0 || elementSize == 0) {
+            std::cerr << "Файл не в двоичном формате чисел: " << filename << std::endl;
+            return false;
+        }
+        if (header.count != (size - sizeof(header)) / elementSize || (size - sizeof(header)) % elementSize != 0) {
+            std::cerr << "Размер файла не совпадает с количеством чисел в заголовке: " << filename << std::endl;
+            return false;
+        }
+        if (binaryChecksum(payload(), size - sizeof(header)) != header.checksum) {
+            std::cerr << "Контрольная сумма не совпадает: " << filename << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    BinaryElementType type() const { return static_cast<BinaryElementType>(header.elementType); }
+    size_t count() const { return static_cast<size_t>(header.count); }
+    const int32_t* integers() const { return static_cast<const int32_t*>(payload()); }
+    const double* doubles() const { return static_cast<const double*>(payload()); }
+
+private:
+    void* address;
+    size_t size;
+    BinaryNumberHeader header;
+
+    const void* payload() const { return static_cast<const char*>(address) + sizeof(BinaryNumberHeader); }
+};
+
+// processNumbers над двоичными файлами: вход int32 читается прямо из
+// отображения в память, выход - float64
+bool processNumbersBinary(const std::string& inputFilename, const std::string& outputFilename) {
+    MappedNumberFile input;
+    {
+        // Чтение - это отображение файла и проверка контрольной суммы
+        NUMBERS_STAGE(timer, Parse);
+        if (!input.open(inputFilename)) {
+            return false;
+        }
+        NUMBERS_STAGE_COUNT(timer, input.count(), sizeof(BinaryNumberHeader) + input.count() * sizeof(int32_t));
+    }
+    if (input.type() != BinaryElementType::Int32) {
+        std::cerr << "Во входном файле должны быть числа int32: " << inputFilename << std::endl;
+        return false;
     }
 
-    // Преобразование чисел
     std::vector<double> transformedNumbers;
-    for (int number : numbers) {
-        if (std::abs(number) % 2 == 1) { // Проверка на нечетность по модулю
-            transformedNumbers.push_back(number / average);
+    if (!transformNumbers(input.integers(), input.count(), transformedNumbers)) {
+        return false;
+    }
+
+    NUMBERS_STAGE(timer, Write);
+    BinaryNumberWriter writer(outputFilename, BinaryElementType::Float64);
+    if (!writer.isOpen()) {
+        std::cerr << "Ошибка при открытии файла для записи: " << outputFilename << std::endl;
+        return false;
+    }
+    writer.append(transformedNumbers.data(), transformedNumbers.size());
+    if (!writer.close()) {
+        std::cerr << "Ошибка при записи в файл: " << outputFilename << std::endl;
+        return false;
+    }
+    NUMBERS_STAGE_COUNT(timer, transformedNumbers.size(), sizeof(BinaryNumberHeader) + transformedNumbers.size() * sizeof(double));
+    return true;
+}
+
+// Текст -> двоичный int32; читаются числа до первого нечитаемого слова, как в readNumbersFromFile
+bool convertTextToBinary(const std::string& inputFilename, const std::string& outputFilename) {
+    if (!hostIsLittleEndian()) {
+        std::cerr << "Двоичный формат поддерживается только на little-endian процессорах." << std::endl;
+        return false;
+    }
+    NumberReader reader(inputFilename);
+    if (!reader.isOpen()) {
+        std::cerr << "Ошибка при открытии файла для чтения: " << inputFilename << std::endl;
+        return false;
+    }
+    BinaryNumberWriter writer(outputFilename, BinaryElementType::Int32);
+    if (!writer.isOpen()) {
+        std::cerr << "Ошибка при открытии файла для записи: " << outputFilename << std::endl;
+        return false;
+    }
+
+    std::vector<int32_t> block(1 << 16);
+    size_t used = 0;
+    int number;
+    while (reader.next(number)) {
+        block[used++] = number;
+        if (used == block.size()) {
+            writer.append(block.data(), used);
+            used = 0;
+        }
+    }
+    writer.append(block.data(), used);
+    if (!writer.close()) {
+        std::cerr << "Ошибка при записи в файл: " << outputFilename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Двоичный -> текст: int32 как целые, float64 - как writeNumbersToFile
+bool convertBinaryToText(const std::string& inputFilename, const std::string& outputFilename) {
+    MappedNumberFile input;
+    if (!input.open(inputFilename)) {
+        return false;
+    }
+    NumberWriter writer(outputFilename);
+    if (!writer.isOpen()) {
+        std::cerr << "Ошибка при открытии файла для записи: " << outputFilename << std::endl;
+        return false;
+    }
+
+    if (input.type() == BinaryElementType::Int32) {
+        for (size_t i = 0; i < input.count(); ++i) {
+            writer.write(static_cast<int>(input.integers()[i]));
+        }
+    } else {
+        for (size_t i = 0; i < input.count(); ++i) {
+            writer.write(input.doubles()[i]);
+        }
+    }
+    if (!writer.close()) {
+        std::cerr << "Ошибка при записи в файл: " << outputFilename << std::endl;
+        return false;
+    }
+    return true;
+}
+#endif
+
+// ---------- Генератор входных данных (laba4.2 --generate) ----------
+//
+// Число номер i - функция только от (seed, i): счетчиковый генератор на
+// перемешивании splitmix64. Поэтому потоки независимо генерируют свои блоки
+// по GENERATOR_BLOCK чисел, а файл при тех же параметрах получается тем же
+// при любом числе потоков. Блоки форматируются параллельно и пишутся по
+// порядку через writeChunksInOrder.
+
+const uint64_t GENERATOR_MAX_COUNT = 10000000000ull;
+const size_t GENERATOR_BLOCK = 1 << 18;
+
+enum class NumberDistribution { Uniform, Normal };
+
+struct GeneratorOptions {
+    uint64_t count = 100;
+    uint64_t seed = 0;
+    int minValue = -50;
+    int maxValue = 50;
+    NumberDistribution distribution = NumberDistribution::Uniform;
+    bool binary = false;
+    unsigned threads = 1;
+};
+
+// Перемешивание splitmix64
+inline uint64_t mixBits(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Случайное 64-битное слово номер counter для ключа key = mixBits(seed)
+inline uint64_t counterRandom(uint64_t key, uint64_t counter) {
+    return mixBits(key + (counter + 1) * 0x9E3779B97F4A7C15ull);
+}
+
+// Число номер index. Равномерное - умножением 32 старших бит на ширину
+// диапазона (смещение меньше ширина / 2^32), нормальное - преобразованием
+// Бокса-Мюллера с центром диапазона и сигмой в шестую часть ширины,
+// обрезанное по краям диапазона
+inline int generateNumber(const GeneratorOptions& options, uint64_t key, uint64_t index) {
+    uint64_t bits = counterRandom(key, index);
+    uint64_t width = static_cast<uint64_t>(static_cast<int64_t>(options.maxValue) - options.minValue) + 1;
+    if (options.distribution == NumberDistribution::Uniform) {
+        return static_cast<int>(options.minValue + static_cast<int64_t>(((bits >> 32) * width) >> 32));
+    }
+    double u1 = (static_cast<double>(bits >> 32) + 1) / 4294967296.0;
+    double u2 = static_cast<double>(bits & 0xFFFFFFFFu) / 4294967296.0;
+    double z = std::sqrt(-2 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+    double value = std::round((static_cast<double>(options.minValue) + options.maxValue) / 2 + z * width / 6);
+    return static_cast<int>(std::min<double>(options.maxValue, std::max<double>(options.minValue, value)));
+}
+
+// Запись options.count чисел в текстовый (по числу в строке) или двоичный файл
+bool generateNumbers(const std::string& filename, const GeneratorOptions& options) {
+    if (options.count > GENERATOR_MAX_COUNT || options.minValue > options.maxValue) {
+        std::cerr << "Неверные параметры генератора: не больше " << GENERATOR_MAX_COUNT
+                  << " чисел, нижняя граница не больше верхней." << std::endl;
+        return false;
+    }
+    uint64_t key = mixBits(options.seed);
+    size_t blocks = static_cast<size_t>((options.count + GENERATOR_BLOCK - 1) / GENERATOR_BLOCK);
+    auto blockRange = [&](size_t block, uint64_t& begin, uint64_t& end) {
+        begin = static_cast<uint64_t>(block) * GENERATOR_BLOCK;
+        end = std::min<uint64_t>(begin + GENERATOR_BLOCK, options.count);
+    };
+
+    if (options.binary) {
+        if (!hostIsLittleEndian()) {
+            std::cerr << "Двоичный формат поддерживается только на little-endian процессорах." << std::endl;
+            return false;
+        }
+        BinaryNumberWriter writer(filename, BinaryElementType::Int32);
+        if (!writer.isOpen()) {
+            std::cerr << "Ошибка при открытии файла для записи: " << filename << std::endl;
+            return false;
+        }
+        writeChunksInOrder(
+            blocks, options.threads,
+            [&](size_t block, std::vector<char>& data) {
+                uint64_t begin, end;
+                blockRange(block, begin, end);
+                data.resize(GENERATOR_BLOCK * sizeof(int32_t));
+                for (uint64_t i = begin; i < end; ++i) {
+                    int32_t number = generateNumber(options, key, i);
+                    std::memcpy(data.data() + (i - begin) * sizeof(int32_t), &number, sizeof(int32_t));
+                }
+                return static_cast<size_t>(end - begin) * sizeof(int32_t);
+            },
+            [&](const char* data, size_t size) {
+                writer.append(data, size / sizeof(int32_t));
+                return true;
+            });
+        if (!writer.close()) {
+            std::cerr << "Ошибка при записи в файл: " << filename << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    std::FILE* output = std::fopen(filename.c_str(), "w");
+    if (!output) {
+        std::cerr << "Ошибка при открытии файла для записи: " << filename << std::endl;
+        return false;
+    }
+    bool ok = writeChunksInOrder(
+        blocks, options.threads,
+        [&](size_t block, std::vector<char>& text) {
+            uint64_t begin, end;
+            blockRange(block, begin, end);
+            // Число int - не больше 11 символов и перевод строки
+            text.resize(GENERATOR_BLOCK * 12);
+            char* out = text.data();
+            for (uint64_t i = begin; i < end; ++i) {
+                out = std::to_chars(out, out + 11, generateNumber(options, key, i)).ptr;
+                *out++ = '\n';
+            }
+            return static_cast<size_t>(out - text.data());
+        },
+        [&](const char* data, size_t size) { return std::fwrite(data, 1, size, output) == size; });
+    ok = std::fclose(output) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Ошибка при записи в файл: " << filename << std::endl;
+    }
+    return ok;
+}
+
+// Целое число из аргумента целиком: без знаков после числа и без выхода за
+// диапазон T (from_chars сообщает о нем через errc::result_out_of_range)
+template <typename T>
+bool parseIntegerArgument(const char* text, T& value) {
+    const char* end = text + std::strlen(text);
+    std::from_chars_result parsed = std::from_chars(text, end, value);
+    return parsed.ec == std::errc() && parsed.ptr == end;
+}
+
+// Разбор параметров генератора из argv[first..]:
+// [--seed S] [--range MIN MAX] [--normal] [--binary] [--threads N]
+bool parseGeneratorOptions(int argc, char* argv[], int first, GeneratorOptions& options) {
+    for (int i = first; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            if (!parseIntegerArgument(argv[++i], options.seed)) {
+                std::cerr << "Неверное значение --seed: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (std::strcmp(argv[i], "--range") == 0 && i + 2 < argc) {
+            long long bounds[2];
+            for (long long& bound : bounds) {
+                ++i;
+                if (!parseIntegerArgument(argv[i], bound) || bound < std::numeric_limits<int>::min() ||
+                    bound > std::numeric_limits<int>::max()) {
+                    std::cerr << "Неверная граница --range (нужно целое число типа int): " << argv[i] << std::endl;
+                    return false;
+                }
+            }
+            options.minValue = static_cast<int>(bounds[0]);
+            options.maxValue = static_cast<int>(bounds[1]);
+        } else if (std::strcmp(argv[i], "--normal") == 0) {
+            options.distribution = NumberDistribution::Normal;
+        } else if (std::strcmp(argv[i], "--binary") == 0) {
+            options.binary = true;
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            if (!parseIntegerArgument(argv[++i], options.threads)) {
+                std::cerr << "Неверное значение --threads: " << argv[i] << std::endl;
+                return false;
+            }
+            options.threads = std::max(1u, options.threads);
         } else {
-            transformedNumbers.push_back(number); // Четные остаются без изменений
+            std::cerr << "Неизвестный параметр генератора: " << argv[i] << std::endl;
+            return false;
         }
     }
+    return true;
+}
 
-    // Запись преобразованных чисел в выходной файл
-    writeNumbersToFile(outputFilename, transformedNumbers);
+// Функция для создания входного файла со 100 случайными числами в диапазоне [-50, 50]
+void prepareInputFile(const std::string& filename) {
+    GeneratorOptions options;
+    options.seed = static_cast<uint64_t>(std::time(nullptr)); // Новые числа при каждом запуске
+    generateNumbers(filename, options);
+}
+
+// Проверка ядер на совпадение с исходными циклами processNumbers
+bool checkNumberKernels() {
+    std::vector<int> numbers(4099);
+    uint32_t state = 7;
+    bool ok = true;
+    for (int round = 0; round < 200; ++round) {
+        for (size_t i = 0; i < numbers.size(); ++i) {
+            state = state * 1664525u + 1013904223u;
+            // Чередуются малые числа и весь диапазон int с краевыми значениями
+            numbers[i] = round % 2 ? static_cast<int>(state) : static_cast<int>(state >> 24) - 128;
+        }
+        numbers[round % numbers.size()] = INT32_MIN;
+        numbers[(round * 7) % numbers.size()] = INT32_MAX;
+        size_t n = round < 100 ? static_cast<size_t>(round) : numbers.size() - round % 8;
+
+        // Исходные циклы
+        double sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            sum += std::abs(numbers[i]);
+        }
+        double average = n ? sum / n : 1;
+        std::vector<double> expected;
+        for (size_t i = 0; i < n; ++i) {
+            if (std::abs(numbers[i]) % 2 == 1) {
+                expected.push_back(numbers[i] / average);
+            } else {
+                expected.push_back(numbers[i]);
+            }
+        }
+
+        for (const NumberKernels& kernels : availableNumberKernels()) {
+            std::vector<double> out(n);
+            bool sameSum = static_cast<double>(kernels.absSum(numbers.data(), n)) == sum;
+            kernels.transform(numbers.data(), n, average, out.data());
+            bool sameOut = n == 0 || std::memcmp(out.data(), expected.data(), n * sizeof(double)) == 0;
+            if (!sameSum || !sameOut) {
+                std::cout << kernels.name << ": расхождение при n = " << n << (sameSum ? " (преобразование)" : " (сумма)")
+                          << std::endl;
+                ok = false;
+            }
+        }
+    }
+    for (const NumberKernels& kernels : availableNumberKernels()) {
+        std::cout << kernels.name << " ";
+    }
+    std::cout << (ok ? "- совпадают с исходными циклами" : "- ЕСТЬ РАСХОЖДЕНИЯ") << std::endl;
+    return ok;
+}
+
+// Скорость ядер в элементах в секунду
+void benchmarkNumberKernels(size_t count) {
+    std::vector<int> numbers(count);
+    uint32_t state = 2024;
+    for (int& number : numbers) {
+        state = state * 1664525u + 1013904223u;
+        number = static_cast<int>(state >> 8) % 2000001 - 1000000;
+    }
+    std::vector<double> out(count);
+    const int repeats = 10;
+    auto seconds = [](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    // Исходные циклы для сравнения
+    volatile double sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        double sum = 0;
+        for (int number : numbers) {
+            sum += std::abs(number);
+        }
+        sink = sink + sum;
+    }
+    double loopSum = seconds(start) / repeats;
+    double average = 500000.5;
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        std::vector<double> transformed;
+        for (int number : numbers) {
+            if (std::abs(number) % 2 == 1) {
+                transformed.push_back(number / average);
+            } else {
+                transformed.push_back(number);
+            }
+        }
+        sink = sink + transformed.back();
+    }
+    double loopTransform = seconds(start) / repeats;
+
+    std::cout << "Элементов: " << count << ", млн элементов/с (сумма модулей / преобразование)" << std::endl;
+    std::cout << "исходные циклы: " << count / loopSum / 1e6 << " / " << count / loopTransform / 1e6 << std::endl;
+    for (const NumberKernels& kernels : availableNumberKernels()) {
+        int64_t total = 0;
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r) {
+            total += kernels.absSum(numbers.data(), count);
+        }
+        double sumTime = seconds(start) / repeats;
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r) {
+            kernels.transform(numbers.data(), count, average, out.data());
+        }
+        double transformTime = seconds(start) / repeats;
+        sink = sink + static_cast<double>(total) + out[count / 2];
+        std::cout << kernels.name << ": " << count / sumTime / 1e6 << " / " << count / transformTime / 1e6 << std::endl;
+    }
+}
+
+// Микробенчмарк ввода-вывода (laba4.2 --bench-io [count]): разбор и
+// форматирование в памяти через from_chars/to_chars и через потоки
+void benchmarkNumberIo(size_t count) {
+    std::vector<int> numbers(count);
+    uint32_t state = 2024;
+    for (int& number : numbers) {
+        state = state * 1664525u + 1013904223u;
+        number = static_cast<int>(state >> 8) % 2000001 - 1000000;
+    }
+    std::string text;
+    for (int number : numbers) {
+        char digits[16];
+        text.append(digits, std::to_chars(digits, digits + sizeof(digits), number).ptr);
+        text += '\n';
+    }
+    double average = 500000.5;
+    std::vector<double> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = numbers[i] % 2 != 0 ? numbers[i] / average : numbers[i];
+    }
+    auto seconds = [](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    // Разбор
+    std::vector<int> parsed;
+    parsed.reserve(count);
+    auto start = std::chrono::steady_clock::now();
+    const char* p = text.data();
+    int number;
+    while (parseNextNumber(p, text.data() + text.size(), true, number) == ParseStatus::Ok) {
+        parsed.push_back(number);
+    }
+    double fastParse = seconds(start);
+    bool parseSame = parsed == numbers;
+
+    parsed.clear();
+    start = std::chrono::steady_clock::now();
+    std::istringstream in(text);
+    while (in >> number) {
+        parsed.push_back(number);
+    }
+    double streamParse = seconds(start);
+    parseSame = parseSame && parsed == numbers;
+
+    // Форматирование
+    std::string fastText(count * 16, '\0');
+    start = std::chrono::steady_clock::now();
+    char* out = &fastText[0];
+    for (double value : values) {
+        out = std::to_chars(out, out + 15, value, std::chars_format::general, 6).ptr;
+        *out++ = '\n';
+    }
+    double fastFormat = seconds(start);
+    fastText.resize(static_cast<size_t>(out - fastText.data()));
+
+    start = std::chrono::steady_clock::now();
+    std::ostringstream streamOut;
+    for (double value : values) {
+        streamOut << value << '\n';
+    }
+    double streamFormat = seconds(start);
+    bool formatSame = streamOut.str() == fastText;
+
+    double parseGb = text.size() / 1e9;
+    double formatGb = fastText.size() / 1e9;
+    std::cout << "Чисел: " << count << ", текст ввода " << text.size() / 1e6 << " МБ, вывода " << fastText.size() / 1e6
+              << " МБ" << std::endl;
+    std::cout << "Разбор: from_chars " << parseGb / fastParse << " ГБ/с, operator>> " << parseGb / streamParse
+              << " ГБ/с (в " << streamParse / fastParse << " раз быстрее), результат "
+              << (parseSame ? "совпадает" : "РАЗЛИЧАЕТСЯ") << std::endl;
+    std::cout << "Запись: to_chars " << formatGb / fastFormat << " ГБ/с, operator<< " << formatGb / streamFormat
+              << " ГБ/с (в " << streamFormat / fastFormat << " раз быстрее), текст "
+              << (formatSame ? "совпадает" : "РАЗЛИЧАЕТСЯ") << std::endl;
+}
+
+// Прогон processNumbers на входах из 10^3 .. maxCount чисел
+// (laba4.2 --bench-pipeline [maxCount]): время всего конвейера, МБ/с по
+// входному тексту и нс на число; в сборке с NUMBERS_PROFILE - еще и итоги
+// каждой стадии. Входы создает генератор с постоянным seed
+void benchmarkPipeline(uint64_t maxCount) {
+    const std::string inputFilename = "pipeline_input.txt";
+    const std::string outputFilename = "pipeline_output.txt";
+    std::printf("%12s %10s %10s %10s %10s\n", "elements", "input MB", "ms", "MB/s", "ns/elem");
+    for (uint64_t count = 1000; count <= maxCount; count *= 10) {
+        GeneratorOptions options;
+        options.count = count;
+        options.seed = 42;
+        options.minValue = -1000000;
+        options.maxValue = 1000000;
+        options.threads = std::max(1u, std::thread::hardware_concurrency());
+        if (!generateNumbers(inputFilename, options)) {
+            return;
+        }
+        double inputBytes = 0;
+        if (std::FILE* input = std::fopen(inputFilename.c_str(), "rb")) {
+            std::fseek(input, 0, SEEK_END);
+            inputBytes = static_cast<double>(std::ftell(input));
+            std::fclose(input);
+        }
+
+        // Малые входы повторяются, чтобы замер шел не меньше ~10^7 чисел
+        uint64_t repeats = std::max<uint64_t>(1, 10000000 / count);
+#ifdef NUMBERS_PROFILE
+        resetStageStats();
+#endif
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t r = 0; r < repeats; ++r) {
+            processNumbers(inputFilename, outputFilename);
+        }
+        double nanoseconds =
+            std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / repeats;
+        std::printf("%12llu %10.2f %10.3f %10.1f %10.2f\n", static_cast<unsigned long long>(count), inputBytes / 1e6,
+                    nanoseconds / 1e6, inputBytes * 1e3 / nanoseconds, nanoseconds / count);
+#ifdef NUMBERS_PROFILE
+        printStageReport(std::cout, false);
+        resetStageStats();
+#endif
+    }
+    std::remove(inputFilename.c_str());
+    std::remove(outputFilename.c_str());
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // laba4.2 --stream <input> <output> - потоковая обработка большого файла
+    if (argc > 3 && std::strcmp(argv[1], "--stream") == 0) {
+        return processNumbersStreaming(argv[2], argv[3]) ? 0 : 1;
+    }
+
+#ifdef NUMBERS_HAS_MMAP
+    // laba4.2 --parallel <input> <output> [threads] - обработка на всех ядрах
+    if (argc > 3 && std::strcmp(argv[1], "--parallel") == 0) {
+        unsigned threads = argc > 4 ? static_cast<unsigned>(std::strtoul(argv[4], nullptr, 10))
+                                    : std::thread::hardware_concurrency();
+        return processNumbersParallel(argv[2], argv[3], std::max(1u, threads)) ? 0 : 1;
+    }
+#endif
+
+#ifdef NUMBERS_HAS_MMAP
+    // laba4.2 --binary <input.bin> <output.bin> - обработка в двоичном формате,
+    // --to-binary <input.txt> <output.bin> и --to-text <input.bin> <output.txt> - преобразование форматов
+    if (argc > 3 && std::strcmp(argv[1], "--binary") == 0) {
+        return processNumbersBinary(argv[2], argv[3]) ? 0 : 1;
+    }
+    if (argc > 3 && std::strcmp(argv[1], "--to-binary") == 0) {
+        return convertTextToBinary(argv[2], argv[3]) ? 0 : 1;
+    }
+    if (argc > 3 && std::strcmp(argv[1], "--to-text") == 0) {
+        return convertBinaryToText(argv[2], argv[3]) ? 0 : 1;
+    }
+#endif
+
+    // laba4.2 --generate <output> <count> [--seed S] [--range MIN MAX] [--normal] [--binary] [--threads N]
+    if (argc > 3 && std::strcmp(argv[1], "--generate") == 0) {
+        GeneratorOptions options;
+        if (!parseIntegerArgument(argv[3], options.count)) {
+            std::cerr << "Неверное количество чисел: " << argv[3] << std::endl;
+            return 1;
+        }
+        options.threads = std::max(1u, std::thread::hardware_concurrency());
+        if (!parseGeneratorOptions(argc, argv, 4, options)) {
+            return 1;
+        }
+        return generateNumbers(argv[2], options) ? 0 : 1;
+    }
+
+    // laba4.2 --simd-check - проверка векторных ядер, --bench-simd [count] - их скорость
+    if (argc > 1 && std::strcmp(argv[1], "--simd-check") == 0) {
+        return checkNumberKernels() ? 0 : 1;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "--bench-simd") == 0) {
+        benchmarkNumberKernels(argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000000);
+        return 0;
+    }
+
+    // laba4.2 --bench-pipeline [maxCount] - весь конвейер на входах разного размера
+    if (argc > 1 && std::strcmp(argv[1], "--bench-pipeline") == 0) {
+        benchmarkPipeline(argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000000);
+        return 0;
+    }
+
+    if (argc > 1 && std::strcmp(argv[1], "--bench-io") == 0) {
+        benchmarkNumberIo(argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000000);
+        return 0;
+    }
+
     const std::string inputFilename = "input.txt";
     const std::string outputFilename = "output.txt";
 
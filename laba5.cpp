@@ -2,6 +2,39 @@
 #include <initializer_list>
 #include <stdexcept>
 #include <string>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <algorithm>
+#include <iterator>
+#include <execution>
+#include <utility>
+#include <chrono>
+#include <cstring>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <exception>
+#include <functional>
+#include <vector>
+#include <optional>
+#include <deque>
+#include <queue>
+#include <fstream>
+#include <ctime>
+#include <cstdio>
+#include <cerrno>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CONTAINERS_HAS_MMAP 1
+#endif
 
 // Класс исключений CustomException
 // Используется для генерации пользовательских исключений с сообщением.
@@ -21,246 +54,2842 @@ public:
 
 namespace containers {
 
-    // Класс Queue - реализация очереди
-    template <typename T>
-    class Queue {
+    // Хранилище NodeStorage - двусвязный список узлов (используется по умолчанию).
+    // Доступ по индексу - O(n), обход в обе стороны - без дополнительной памяти. Узлы берутся из встроенного пула: память
+    // выделяется через Allocator слэбами по нескольку узлов, а узлы, освобожденные
+    // в pop, попадают в список свободных и переиспользуются следующими push.
+    // Поэтому в установившемся режиме push/pop не обращаются к аллокатору вовсе.
+    template <typename T, typename Allocator = std::allocator<T>>
+    class NodeStorage {
+    public:
+        using allocator_type = Allocator;
+
     private:
-        // Узел очереди, содержащий значение и указатель на следующий узел
+        // Узел списка; значение создается в сырой памяти через аллокатор
         struct Node {
-            T value;    // Значение узла
-            Node* next; // Указатель на следующий узел
+            Node* next;                                  // Указатель на следующий узел
+            Node* prev;                                  // Указатель на предыдущий узел
+            alignas(T) unsigned char storage[sizeof(T)]; // Память под значение
 
-            // Конструкторы узла
-            Node(const T& val) : value(val), next(nullptr) {}
-            Node(T&& val) : value(std::move(val)), next(nullptr) {}
+            T* ptr() { return std::launder(reinterpret_cast<T*>(storage)); }
+            T& value() { return *ptr(); }
+        };
 
-            // Объявляем класс Queue другом для доступа к private-членам
-            friend class Queue;
+        // Блок слэба: занятый узел, звено списка свободных блоков или заголовок слэба
+        union Block {
+            Node node;
+            Block* nextFree;
+            struct {
+                Block* nextSlab; // Следующий слэб
+                size_t blocks;   // Число блоков в слэбе вместе с заголовком
+            } header;
         };
 
-        Node* front; // Указатель на первый элемент очереди
-        Node* back;  // Указатель на последний элемент очереди
-        size_t count; // Количество элементов в очереди
+        using AllocTraits = std::allocator_traits<Allocator>;
+        using ValueAlloc = typename AllocTraits::template rebind_alloc<T>;
+        using ValueTraits = std::allocator_traits<ValueAlloc>;
+        using BlockAlloc = typename AllocTraits::template rebind_alloc<Block>;
+        using BlockTraits = std::allocator_traits<BlockAlloc>;
+
+        static constexpr size_t minSlabBlocks = 16;   // Узлов в первом слэбе
+        static constexpr size_t maxSlabBlocks = 1024; // Предельное число узлов в слэбе
+
+        Allocator alloc; // Аллокатор, из которого берутся слэбы
+        Node* front;     // Указатель на первый элемент
+        Node* back;      // Указатель на последний элемент
+        size_t count;    // Количество элементов
+
+        Block* slabs;          // Список всех слэбов
+        Block* freeList;       // Освобожденные узлы
+        Block* bump;           // Начало неразмеченной части текущего слэба
+        size_t bumpLeft;       // Сколько неразмеченных блоков осталось
+        size_t nextSlabBlocks; // Размер следующего слэба (удваивается до maxSlabBlocks)
+        size_t allocationCount; // Сколько раз этот объект обращался к аллокатору
 
     public:
-        // Конструктор по умолчанию
-        Queue() : front(nullptr), back(nullptr), count(0) {}
+        // Двунаправленный итератор по узлам (Const - только для чтения).
+        // end() хранит nullptr, поэтому для --end() итератор помнит свое хранилище.
+        template <bool Const>
+        class Iter {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<Const, const T*, T*>;
+            using reference = std::conditional_t<Const, const T&, T&>;
 
-        // Конструктор с инициализатором списка
-        Queue(std::initializer_list<T> init_list) : Queue() {
-            for (const auto& elem : init_list) {
-                push(elem); // Добавляем элементы в очередь
-            }
-        }
+            Iter() : current(nullptr), owner(nullptr) {}
+            Iter(Node* node, const NodeStorage* storage) : current(node), owner(storage) {}
 
-        // Конструктор копирования
-        Queue(const Queue& other) : Queue() {
-            Node* current = other.front;
-            while (current) {
-                push(current->value); // Копируем элементы очереди
+            // Неконстантный итератор неявно приводится к константному
+            template <bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+            Iter(const Iter<OtherConst>& other) : current(other.current), owner(other.owner) {}
+
+            reference operator*() const { return current->value(); }
+            pointer operator->() const { return current->ptr(); }
+
+            Iter& operator++() {
                 current = current->next;
+                return *this;
+            }
+
+            Iter operator++(int) {
+                Iter old = *this;
+                ++*this;
+                return old;
+            }
+
+            Iter& operator--() {
+                current = current ? current->prev : owner->back;
+                return *this;
+            }
+
+            Iter operator--(int) {
+                Iter old = *this;
+                --*this;
+                return old;
+            }
+
+            friend bool operator==(const Iter& a, const Iter& b) { return a.current == b.current; }
+            friend bool operator!=(const Iter& a, const Iter& b) { return a.current != b.current; }
+
+        private:
+            template <bool> friend class Iter;
+
+            Node* current;            // Текущий узел (nullptr - конец)
+            const NodeStorage* owner; // Хранилище, которому принадлежит узел
+        };
+
+        using iterator = Iter<false>;
+        using const_iterator = Iter<true>;
+
+        NodeStorage() : NodeStorage(Allocator()) {}
+
+        explicit NodeStorage(const Allocator& allocator)
+            : alloc(allocator), front(nullptr), back(nullptr), count(0),
+              slabs(nullptr), freeList(nullptr), bump(nullptr), bumpLeft(0), nextSlabBlocks(minSlabBlocks),
+              allocationCount(0) {}
+
+        NodeStorage(const NodeStorage& other)
+            : NodeStorage(other, AllocTraits::select_on_container_copy_construction(other.alloc)) {}
+
+        // Копирование с явно заданным аллокатором
+        NodeStorage(const NodeStorage& other, const Allocator& allocator) : NodeStorage(allocator) {
+            reserve(other.count);
+            for (const T& value : other) {
+                emplace_back(value);
             }
         }
 
-        // Конструктор перемещения
-        Queue(Queue&& other) noexcept
-            : front(other.front), back(other.back), count(other.count) {
-            // Обнуляем элементы у исходного объекта
-            other.front = other.back = nullptr;
-            other.count = 0;
+        NodeStorage(NodeStorage&& other) noexcept : NodeStorage(other.alloc) {
+            takeFrom(other);
         }
 
-        // Оператор присваивания копированием
-        Queue& operator=(const Queue& other) {
-            if (this != &other) { // Защита от самоприсваивания
-                clear(); // Очищаем текущую очередь
-                Node* current = other.front;
-                while (current) {
-                    push(current->value); // Копируем элементы
-                    current = current->next;
+        NodeStorage& operator=(const NodeStorage& other) {
+            if (this != &other) {
+                // Сначала копируем, затем подменяем содержимое
+                NodeStorage copy(other, AllocTraits::propagate_on_container_copy_assignment::value ? other.alloc : alloc);
+                clear();
+                if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                    alloc = copy.alloc;
                 }
+                takeFrom(copy);
             }
             return *this;
         }
 
-        // Оператор присваивания перемещением
-        Queue& operator=(Queue&& other) noexcept {
+        NodeStorage& operator=(NodeStorage&& other) noexcept(
+            AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) {
             if (this != &other) {
-                clear(); // Очищаем текущую очередь
-                front = other.front;
-                back = other.back;
-                count = other.count;
-                // Обнуляем исходный объект
-                other.front = other.back = nullptr;
-                other.count = 0;
+                clear();
+                if (AllocTraits::propagate_on_container_move_assignment::value || alloc == other.alloc) {
+                    if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                        alloc = other.alloc;
+                    }
+                    takeFrom(other);
+                } else {
+                    // Разные ресурсы памяти (например, std::pmr) - перемещаем поэлементно
+                    for (T& value : other) {
+                        emplace_back(std::move(value));
+                    }
+                    other.clear();
+                }
             }
             return *this;
         }
 
-        // Деструктор
-        ~Queue() {
-            clear(); // Удаляем все элементы
+        ~NodeStorage() {
+            clear();
         }
 
-        // Добавление элемента в конец очереди
-        void push(const T& value) {
-            Node* newNode = new Node(value); // Создаем новый узел
-            if (empty()) {
-                front = back = newNode; // Если очередь пуста, новый узел становится первым и последним
-            } else {
-                back->next = newNode; // Присоединяем новый узел к концу
-                back = newNode;       // Обновляем указатель на последний элемент
+        allocator_type get_allocator() const { return alloc; }
+
+        void swap(NodeStorage& other) noexcept {
+            if constexpr (AllocTraits::propagate_on_container_swap::value) {
+                std::swap(alloc, other.alloc);
             }
-            ++count; // Увеличиваем счетчик элементов
+            std::swap(front, other.front);
+            std::swap(back, other.back);
+            std::swap(count, other.count);
+            std::swap(slabs, other.slabs);
+            std::swap(freeList, other.freeList);
+            std::swap(bump, other.bump);
+            std::swap(bumpLeft, other.bumpLeft);
+            std::swap(nextSlabBlocks, other.nextSlabBlocks);
+            std::swap(allocationCount, other.allocationCount);
         }
 
-        // Удаление элемента из начала очереди
-        void pop() {
-            if (empty()) {
-                throw CustomException("Queue is empty"); // Исключение, если очередь пуста
+        void push_back(const T& value) {
+            emplace_back(value);
+        }
+
+        void push_back(T&& value) {
+            emplace_back(std::move(value));
+        }
+
+        // Создание элемента прямо в узле, взятом из пула
+        template <typename... Args>
+        T& emplace_back(Args&&... args) {
+            Node* newNode = allocateNode();
+            try {
+                ValueAlloc valueAlloc(alloc);
+                ValueTraits::construct(valueAlloc, reinterpret_cast<T*>(newNode->storage), std::forward<Args>(args)...);
+            } catch (...) {
+                releaseNode(newNode);
+                throw;
             }
-            Node* oldFront = front; // Сохраняем указатель на текущий первый элемент
-            front = front->next;   // Смещаем указатель на следующий элемент
-            delete oldFront;       // Удаляем старый первый элемент
-            --count; // Уменьшаем счетчик элементов
-            if (empty()) {
-                back = nullptr; // Если очередь пуста, обнуляем указатель на последний элемент
+            newNode->next = nullptr;
+            newNode->prev = back;
+            if (count == 0) {
+                front = back = newNode;
+            } else {
+                back->next = newNode;
+                back = newNode;
             }
+            ++count;
+            return newNode->value();
         }
 
-        // Доступ к элементу по индексу (без удаления)
-        T& operator[](size_t index) {
-            if (index >= count) {
-                throw CustomException("Index out of range"); // Исключение, если индекс вне диапазона
+        // Удаление первого элемента (очередь не должна быть пустой)
+        void pop_front() {
+            Node* oldFront = front;
+            front = front->next;
+            if (front) {
+                front->prev = nullptr;
             }
+            destroyValue(oldFront);
+            releaseNode(oldFront); // Узел возвращается в пул, а не аллокатору
+            --count;
+            if (count == 0) {
+                back = nullptr;
+            }
+        }
+
+        T& front_value() {
+            return front->value();
+        }
+
+        // Доступ по индексу - проход по списку от начала
+        T& at(size_t index) {
             Node* current = front;
             for (size_t i = 0; i < index; ++i) {
-                current = current->next; // Переход к нужному элементу
+                current = current->next;
             }
-            return current->value;
+            return current->value();
         }
 
-        // Возвращает количество элементов в очереди
-        size_t size() const {
-            return count;
-        }
+        size_t size() const { return count; }
 
-        // Проверяет, пуста ли очередь
-        bool empty() const {
-            return count == 0;
+        size_t allocations() const { return allocationCount; }
+
+        // Подготовка узлов минимум под n элементов одним слэбом
+        // (узлы из списка свободных не учитываются - оценка консервативная)
+        void reserve(size_t n) {
+            if (n > count && n - count > bumpLeft) {
+                addSlab(n - count);
+            }
         }
 
-        // Удаляет все элементы из очереди
+        // Уничтожение всех элементов и возврат аллокатору сразу целых слэбов
         void clear() {
-            while (!empty()) {
-                pop(); // Удаляем элементы по одному
+            if constexpr (!std::is_trivially_destructible<T>::value) {
+                for (Node* current = front; current; current = current->next) {
+                    destroyValue(current);
+                }
             }
+            front = back = nullptr;
+            count = 0;
+            releaseSlabs();
         }
 
-        // Отображение всех элементов очереди
-        void display() const {
-            Node* current = front;
-            while (current) {
-                std::cout << current->value << " ";
-                current = current->next;
+        iterator begin() { return iterator(front, this); }
+        iterator end() { return iterator(nullptr, this); }
+        const_iterator begin() const { return const_iterator(front, this); }
+        const_iterator end() const { return const_iterator(nullptr, this); }
+
+    private:
+        // Забирает все узлы и слэбы у other, оставляя его пустым
+        void takeFrom(NodeStorage& other) noexcept {
+            front = other.front;
+            back = other.back;
+            count = other.count;
+            slabs = other.slabs;
+            freeList = other.freeList;
+            bump = other.bump;
+            bumpLeft = other.bumpLeft;
+            nextSlabBlocks = other.nextSlabBlocks;
+            other.front = other.back = nullptr;
+            other.count = 0;
+            other.slabs = other.freeList = other.bump = nullptr;
+            other.bumpLeft = 0;
+            other.nextSlabBlocks = minSlabBlocks;
+        }
+
+        // Выдача узла: из списка свободных, иначе из текущего слэба, иначе из нового слэба
+        Node* allocateNode() {
+            if (freeList) {
+                Block* block = freeList;
+                freeList = block->nextFree;
+                return &block->node;
             }
-            std::cout << std::endl;
+            if (bumpLeft == 0) {
+                addSlab();
+            }
+            --bumpLeft;
+            return &(bump++)->node;
         }
 
-        // Интерфейс для итераторов
-        class Iterator {
-        public:
-            virtual ~Iterator() = default;
-            virtual bool hasNext() = 0; // Проверка наличия следующего элемента
-            virtual T& next() = 0;      // Возвращает следующий элемент
-        };
+        void releaseNode(Node* node) noexcept {
+            Block* block = reinterpret_cast<Block*>(node);
+            block->nextFree = freeList;
+            freeList = block;
+        }
+
+        void destroyValue(Node* node) noexcept {
+            ValueAlloc valueAlloc(alloc);
+            ValueTraits::destroy(valueAlloc, node->ptr());
+        }
 
-        // Итератор для прямого обхода
-        class ForwardIterator : public Iterator {
+        void addSlab() {
+            addSlab(nextSlabBlocks);
+            nextSlabBlocks = std::min(nextSlabBlocks * 2, maxSlabBlocks);
+        }
+
+        // Новый слэб на blocks узлов; остаток текущего слэба уходит в список свободных
+        void addSlab(size_t blocks) {
+            BlockAlloc blockAlloc(alloc);
+            Block* slab = BlockTraits::allocate(blockAlloc, blocks + 1);
+            ++allocationCount;
+            slab->header.nextSlab = slabs;
+            slab->header.blocks = blocks + 1;
+            slabs = slab;
+            for (; bumpLeft > 0; --bumpLeft) {
+                releaseNode(&(bump++)->node);
+            }
+            bump = slab + 1;
+            bumpLeft = blocks;
+        }
+
+        void releaseSlabs() noexcept {
+            BlockAlloc blockAlloc(alloc);
+            while (slabs) {
+                Block* slab = slabs;
+                slabs = slab->header.nextSlab;
+                BlockTraits::deallocate(blockAlloc, slab, slab->header.blocks);
+            }
+            freeList = bump = nullptr;
+            bumpLeft = 0;
+            nextSlabBlocks = minSlabBlocks;
+        }
+    };
+
+    // Хранилище RingStorage - растущий кольцевой буфер.
+    // Элементы лежат непрерывно, доступ по индексу - O(1), память выделяется
+    // только при удвоении емкости, а не на каждый push.
+    //
+    // Замеры (`laba5 bench`, g++ -O2, 1 ядро x86-64, нс на операцию;
+    // для Node operator[] - среднее по очереди из 10^4 элементов):
+    //                      push    pop    operator[]
+    //   int     Node       12.5    3.8    ~12000
+    //   int     Ring        3.0    0.7    1.8
+    //   string  Node       90     18      ~13000
+    //   string  Ring       80     17      1.8
+    // Для std::string время push определяется копированием самой строки.
+    // (Node - с пулом узлов; до его появления push/pop int стоили 45/13 нс.)
+    template <typename T, typename Allocator = std::allocator<T>>
+    class RingStorage {
+    public:
+        using allocator_type = Allocator;
+
+    private:
+        using AllocTraits = std::allocator_traits<Allocator>;
+        using ValueAlloc = typename AllocTraits::template rebind_alloc<T>;
+        using ValueTraits = std::allocator_traits<ValueAlloc>;
+
+        ValueAlloc alloc; // Аллокатор буфера
+        T* buffer;        // Непрерывный буфер элементов
+        size_t capacity;  // Емкость буфера (всегда степень двойки)
+        size_t head;      // Позиция первого элемента в буфере
+        size_t count;     // Количество элементов
+        size_t allocationCount; // Сколько раз этот объект обращался к аллокатору
+
+        static constexpr size_t initialCapacity = 16;
+
+        // Позиция элемента с логическим индексом index внутри буфера
+        size_t slot(size_t index) const {
+            return (head + index) & (capacity - 1);
+        }
+
+    public:
+        // Итератор произвольного доступа: логический индекс внутри кольца
+        template <bool Const>
+        class Iter {
         private:
-            Node* current;
+            using Owner = std::conditional_t<Const, const RingStorage, RingStorage>;
 
         public:
-            explicit ForwardIterator(Node* start) : current(start) {}
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<Const, const T*, T*>;
+            using reference = std::conditional_t<Const, const T&, T&>;
+
+            Iter() : owner(nullptr), index(0) {}
+            Iter(Owner* storage, size_t position) : owner(storage), index(position) {}
+
+            // Неконстантный итератор неявно приводится к константному
+            template <bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+            Iter(const Iter<OtherConst>& other) : owner(other.owner), index(other.index) {}
+
+            reference operator*() const { return owner->buffer[owner->slot(index)]; }
+            pointer operator->() const { return &**this; }
+            reference operator[](difference_type n) const { return *(*this + n); }
+
+            Iter& operator++() { ++index; return *this; }
+            Iter operator++(int) { Iter old = *this; ++index; return old; }
+            Iter& operator--() { --index; return *this; }
+            Iter operator--(int) { Iter old = *this; --index; return old; }
+
+            Iter& operator+=(difference_type n) { index += n; return *this; }
+            Iter& operator-=(difference_type n) { index -= n; return *this; }
+            friend Iter operator+(Iter it, difference_type n) { return it += n; }
+            friend Iter operator+(difference_type n, Iter it) { return it += n; }
+            friend Iter operator-(Iter it, difference_type n) { return it -= n; }
+            friend difference_type operator-(const Iter& a, const Iter& b) {
+                return static_cast<difference_type>(a.index) - static_cast<difference_type>(b.index);
+            }
+
+            friend bool operator==(const Iter& a, const Iter& b) { return a.index == b.index; }
+            friend bool operator!=(const Iter& a, const Iter& b) { return a.index != b.index; }
+            friend bool operator<(const Iter& a, const Iter& b) { return a.index < b.index; }
+            friend bool operator>(const Iter& a, const Iter& b) { return a.index > b.index; }
+            friend bool operator<=(const Iter& a, const Iter& b) { return a.index <= b.index; }
+            friend bool operator>=(const Iter& a, const Iter& b) { return a.index >= b.index; }
+
+        private:
+            template <bool> friend class Iter;
+
+            Owner* owner; // Хранилище
+            size_t index; // Логический индекс элемента
+        };
+
+        using iterator = Iter<false>;
+        using const_iterator = Iter<true>;
+
+        RingStorage() : RingStorage(Allocator()) {}
+
+        explicit RingStorage(const Allocator& allocator)
+            : alloc(allocator), buffer(nullptr), capacity(0), head(0), count(0), allocationCount(0) {}
 
-            bool hasNext() override {
-                return current != nullptr; // Проверяем, есть ли текущий элемент
+        RingStorage(const RingStorage& other)
+            : RingStorage(other, AllocTraits::select_on_container_copy_construction(Allocator(other.alloc))) {}
+
+        // Копирование с явно заданным аллокатором
+        RingStorage(const RingStorage& other, const Allocator& allocator) : RingStorage(allocator) {
+            reserve(other.count);
+            for (const T& value : other) {
+                emplace_back(value);
             }
+        }
+
+        RingStorage(RingStorage&& other) noexcept : RingStorage(Allocator(other.alloc)) {
+            takeFrom(other);
+        }
 
-            T& next() override {
-                if (!current) {
-                    throw CustomException("No more elements in forward iterator");
+        RingStorage& operator=(const RingStorage& other) {
+            if (this != &other) {
+                RingStorage copy(other, Allocator(AllocTraits::propagate_on_container_copy_assignment::value ? other.alloc : alloc));
+                release();
+                if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                    alloc = copy.alloc;
                 }
-                T& value = current->value; // Сохраняем значение текущего элемента
-                current = current->next;  // Переходим к следующему элементу
-                return value;
+                takeFrom(copy);
             }
-        };
+            return *this;
+        }
 
-        // Итератор для обратного обхода
-        class ReverseIterator : public Iterator {
-        private:
-            Node** nodes; // Массив указателей на узлы
-            int index;    // Текущий индекс для обратного обхода
+        RingStorage& operator=(RingStorage&& other) noexcept(
+            AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) {
+            if (this != &other) {
+                release();
+                if (AllocTraits::propagate_on_container_move_assignment::value || alloc == other.alloc) {
+                    if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                        alloc = other.alloc;
+                    }
+                    takeFrom(other);
+                } else {
+                    // Разные ресурсы памяти (например, std::pmr) - перемещаем поэлементно
+                    reserve(other.count);
+                    for (size_t i = 0; i < other.count; ++i) {
+                        emplace_back(std::move(other.at(i)));
+                    }
+                    other.release();
+                }
+            }
+            return *this;
+        }
 
-        public:
-            ReverseIterator(Node* front, size_t count) : nodes(new Node*[count]), index(count - 1) {
-                Node* current = front;
+        ~RingStorage() {
+            release();
+        }
+
+        allocator_type get_allocator() const { return Allocator(alloc); }
+
+        void swap(RingStorage& other) noexcept {
+            if constexpr (AllocTraits::propagate_on_container_swap::value) {
+                std::swap(alloc, other.alloc);
+            }
+            std::swap(buffer, other.buffer);
+            std::swap(capacity, other.capacity);
+            std::swap(head, other.head);
+            std::swap(count, other.count);
+            std::swap(allocationCount, other.allocationCount);
+        }
+
+        void push_back(const T& value) {
+            emplace_back(value);
+        }
+
+        void push_back(T&& value) {
+            emplace_back(std::move(value));
+        }
+
+        template <typename... Args>
+        T& emplace_back(Args&&... args) {
+            if (count == capacity) {
+                grow(capacity ? capacity * 2 : initialCapacity);
+            }
+            T* place = buffer + slot(count);
+            ValueTraits::construct(alloc, place, std::forward<Args>(args)...);
+            ++count;
+            return *place;
+        }
+
+        // Удаление первого элемента (очередь не должна быть пустой)
+        void pop_front() {
+            ValueTraits::destroy(alloc, buffer + head);
+            head = (head + 1) & (capacity - 1);
+            --count;
+        }
+
+        T& front_value() {
+            return buffer[head];
+        }
+
+        T& at(size_t index) {
+            return buffer[slot(index)];
+        }
+
+        size_t size() const { return count; }
+
+        size_t allocations() const { return allocationCount; }
+
+        void clear() {
+            if constexpr (!std::is_trivially_destructible<T>::value) {
                 for (size_t i = 0; i < count; ++i) {
-                    nodes[i] = current; // Заполняем массив узлов
-                    current = current->next;
+                    ValueTraits::destroy(alloc, buffer + slot(i));
+                }
+            }
+            head = count = 0;
+        }
+
+        // Резервирование места минимум под n элементов
+        void reserve(size_t n) {
+            if (n > capacity) {
+                size_t newCapacity = capacity ? capacity : initialCapacity;
+                while (newCapacity < n) {
+                    newCapacity *= 2;
+                }
+                grow(newCapacity);
+            }
+        }
+
+        iterator begin() { return iterator(this, 0); }
+        iterator end() { return iterator(this, count); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, count); }
+
+    private:
+        // Забирает буфер у other, оставляя его пустым
+        void takeFrom(RingStorage& other) noexcept {
+            buffer = other.buffer;
+            capacity = other.capacity;
+            head = other.head;
+            count = other.count;
+            other.buffer = nullptr;
+            other.capacity = other.head = other.count = 0;
+        }
+
+        // Перенос элементов в новый буфер большей емкости (элементы укладываются с нуля)
+        void grow(size_t newCapacity) {
+            T* newBuffer = ValueTraits::allocate(alloc, newCapacity);
+            ++allocationCount;
+            size_t moved = 0;
+            try {
+                for (; moved < count; ++moved) {
+                    ValueTraits::construct(alloc, newBuffer + moved, std::move_if_noexcept(buffer[slot(moved)]));
+                }
+            } catch (...) {
+                for (size_t i = 0; i < moved; ++i) {
+                    ValueTraits::destroy(alloc, newBuffer + i);
                 }
+                ValueTraits::deallocate(alloc, newBuffer, newCapacity);
+                throw;
             }
+            size_t oldCount = count;
+            release();
+            buffer = newBuffer;
+            capacity = newCapacity;
+            count = oldCount;
+        }
 
-            ~ReverseIterator() {
-                delete[] nodes; // Освобождаем память
+        // Уничтожение элементов и освобождение буфера
+        void release() {
+            clear();
+            if (buffer) {
+                ValueTraits::deallocate(alloc, buffer, capacity);
             }
+            buffer = nullptr;
+            capacity = 0;
+        }
+    };
+
+    // Снимок статистики очереди
+    struct QueueStatsSnapshot {
+        size_t depth;       // Текущее число элементов
+        size_t peakDepth;   // Наибольшее число элементов за все время
+        size_t pushes;      // Всего добавлено элементов
+        size_t pops;        // Всего извлечено элементов
+        size_t allocations; // Обращений хранилища к аллокатору
+        size_t sampled;     // Элементов с измеренным временем ожидания
+        double meanWaitNs;  // Среднее время между push и pop
+        double maxWaitNs;   // Наибольшее время между push и pop
+    };
+
+    // Политика без статистики: пустой класс, все проверки отбрасываются при компиляции
+    struct NoStats {
+        static constexpr bool enabled = false;
+    };
+
+    // Политика сбора статистики Queue. Время ожидания (от push до pop) засекается
+    // только у каждого SampleEvery-го элемента, чтобы не обращаться к часам на
+    // каждой операции. Счетчики - relaxed-атомики, которые меняет только
+    // поток-владелец очереди (чтение и запись без атомарного сложения, на x86 -
+    // обычные mov), поэтому stats() можно читать из любого потока: глубина и
+    // счетчики операций в снимке точные, время ожидания - по засеченным элементам.
+    template <size_t SampleEvery = 1>
+    class QueueStats {
+        static_assert(SampleEvery > 0, "SampleEvery must be positive");
+
+    public:
+        static constexpr bool enabled = true;
 
-            bool hasNext() override {
-                return index >= 0; // Проверяем, есть ли элементы для обратного обхода
+        QueueStatsSnapshot snapshot() const {
+            QueueStatsSnapshot result;
+            result.depth = depth.load(std::memory_order_relaxed);
+            result.peakDepth = peakDepth.load(std::memory_order_relaxed);
+            result.pushes = pushes.load(std::memory_order_relaxed);
+            result.pops = pops.load(std::memory_order_relaxed);
+            result.allocations = allocations.load(std::memory_order_relaxed);
+            result.sampled = sampled.load(std::memory_order_relaxed);
+            long long total = waitTotalNs.load(std::memory_order_relaxed);
+            result.meanWaitNs = result.sampled ? static_cast<double>(total) / static_cast<double>(result.sampled) : 0.0;
+            result.maxWaitNs = static_cast<double>(waitMaxNs.load(std::memory_order_relaxed));
+            return result;
+        }
+
+    protected:
+        QueueStats() = default;
+        QueueStats(const QueueStats&) : QueueStats() {} // Статистика не копируется вместе с элементами
+        QueueStats& operator=(const QueueStats&) { return *this; }
+
+        // Добавлен один элемент
+        void onPush(size_t allocationCount) {
+            size_t seq = pushSeq++;
+            size_t current = pushSeq - popSeq;
+            depth.store(current, std::memory_order_relaxed);
+            add(pushes, size_t(1));
+            allocations.store(allocationCount, std::memory_order_relaxed);
+            if (current > peakDepth.load(std::memory_order_relaxed)) {
+                peakDepth.store(current, std::memory_order_relaxed);
+            }
+            if (seq % SampleEvery == 0) {
+                stamps.push_back(std::chrono::steady_clock::now());
             }
+        }
 
-            T& next() override {
-                if (index < 0) {
-                    throw CustomException("No more elements in reverse iterator");
+        // Извлечен один элемент
+        void onPop(size_t allocationCount) {
+            size_t seq = popSeq++;
+            depth.store(pushSeq - popSeq, std::memory_order_relaxed);
+            add(pops, size_t(1));
+            allocations.store(allocationCount, std::memory_order_relaxed);
+            if (seq >= firstStampedSeq && seq % SampleEvery == 0) {
+                long long waited = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - stamps.front()).count();
+                stamps.pop_front();
+                add(sampled, size_t(1));
+                add(waitTotalNs, waited);
+                if (waited > waitMaxNs.load(std::memory_order_relaxed)) {
+                    waitMaxNs.store(waited, std::memory_order_relaxed);
                 }
-                return nodes[index--]->value; // Возвращаем значение и уменьшаем индекс
             }
-        };
+        }
 
-        // Получение итератора для прямого обхода
-        ForwardIterator getForwardIterator() {
-            return ForwardIterator(front);
+        // Содержимое заменено целиком (clear, копирование, перемещение):
+        // у newDepth элементов время добавления неизвестно
+        void onReset(size_t newDepth, size_t allocationCount) {
+            stamps.clear();
+            pushSeq = firstStampedSeq = newDepth;
+            popSeq = 0;
+            depth.store(newDepth, std::memory_order_relaxed);
+            allocations.store(allocationCount, std::memory_order_relaxed);
+            if (newDepth > peakDepth.load(std::memory_order_relaxed)) {
+                peakDepth.store(newDepth, std::memory_order_relaxed);
+            }
         }
 
-        // Получение итератора для обратного обхода
-        ReverseIterator getReverseIterator() {
-            return ReverseIterator(front, count);
+    private:
+        // Прибавление к счетчику, который меняет только поток-владелец
+        template <typename V>
+        static void add(std::atomic<V>& counter, V delta) {
+            counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
         }
+
+        std::atomic<size_t> depth{0};
+        std::atomic<size_t> peakDepth{0};
+        std::atomic<size_t> pushes{0};
+        std::atomic<size_t> pops{0};
+        std::atomic<size_t> allocations{0};
+        std::atomic<size_t> sampled{0};
+        std::atomic<long long> waitTotalNs{0};
+        std::atomic<long long> waitMaxNs{0};
+
+        // Глубина очереди всегда равна pushSeq - popSeq
+        size_t pushSeq = 0;         // Номер следующего добавляемого элемента
+        size_t popSeq = 0;          // Номер следующего извлекаемого элемента
+        size_t firstStampedSeq = 0; // Элементы с меньшими номерами не засекались
+        std::deque<std::chrono::steady_clock::time_point> stamps; // Время push засеченных элементов в очереди
     };
-} // namespace containers
 
-int main() {
-    using namespace containers;
+    // Коды ошибок безысключительного API очереди; нумерация продолжает
+    // коды 101/102 из laba1
+    enum class QueueError {
+        None = 0,
+        Empty = 101,      // Очередь пуста (pop бросил бы "Queue is empty")
+        OutOfRange = 102  // Индекс вне диапазона (operator[] бросил бы "Index out of range")
+    };
 
-    // Создаем очередь с элементами
-    Queue<int> queue{1, 2, 3, 4, 5};
+    // Результат в стиле std::expected: значение либо код ошибки.
+    // value() на ошибке бросает CustomException, как исходный метод
+    template <typename T>
+    class Result {
+    public:
+        Result(T v) : stored(std::move(v)), errorCode(QueueError::None) {}
+        Result(QueueError e) : errorCode(e) {}
 
-    // Прямой обход
-    auto forwardIterator = queue.getForwardIterator();
-    std::cout << "Forward iteration: ";
-    while (forwardIterator.hasNext()) {
-        std::cout << forwardIterator.next() << " ";
-    }
-    std::cout << std::endl;
+        bool has_value() const { return errorCode == QueueError::None; }
+        explicit operator bool() const { return has_value(); }
+        QueueError error() const { return errorCode; }
 
-    // Обратный обход
-    auto reverseIterator = queue.getReverseIterator();
-    std::cout << "Reverse iteration: ";
-    while (reverseIterator.hasNext()) {
-        std::cout << reverseIterator.next() << " ";
-    }
-    std::cout << std::endl;
+        T& value() {
+            if (!has_value()) {
+                throw CustomException(describe(errorCode));
+            }
+            return *stored;
+        }
+        T& operator*() { return *stored; }
+        T* operator->() { return &*stored; }
+
+        template <typename U>
+        T value_or(U&& fallback) const {
+            return has_value() ? *stored : static_cast<T>(std::forward<U>(fallback));
+        }
+
+        static const char* describe(QueueError e) {
+            return e == QueueError::Empty ? "Queue is empty" : "Index out of range";
+        }
+
+    private:
+        std::optional<T> stored;
+        QueueError errorCode;
+    };
+
+    // Результат-ссылка (at_checked): хранит указатель на элемент
+    template <typename T>
+    class Result<T&> {
+    public:
+        Result(T& v) : stored(&v), errorCode(QueueError::None) {}
+        Result(QueueError e) : stored(nullptr), errorCode(e) {}
+
+        bool has_value() const { return errorCode == QueueError::None; }
+        explicit operator bool() const { return has_value(); }
+        QueueError error() const { return errorCode; }
+
+        T& value() const {
+            if (!has_value()) {
+                throw CustomException(Result<int>::describe(errorCode));
+            }
+            return *stored;
+        }
+        T& operator*() const { return *stored; }
+        T* operator->() const { return stored; }
+
+    private:
+        T* stored;
+        QueueError errorCode;
+    };
+
+    // Класс Queue - реализация очереди
+    // Storage задает способ хранения: NodeStorage<T, Allocator> (список узлов)
+    // или RingStorage<T, Allocator> (кольцевой буфер);
+    // Stats - политика статистики: NoStats (ничего не стоит) или QueueStats<N>
+    template <typename T, typename Storage = NodeStorage<T>, typename Stats = NoStats>
+    class Queue : private Stats {
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T&;
+        using const_reference = const T&;
+        using allocator_type = typename Storage::allocator_type;
+
+        // Итераторы: двунаправленные для NodeStorage, произвольного доступа для RingStorage
+        using iterator = typename Storage::iterator;
+        using const_iterator = typename Storage::const_iterator;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    private:
+        Storage storage; // Хранилище элементов очереди
+
+        // Учет добавленного элемента (при NoStats код не генерируется)
+        void notePush() {
+            if constexpr (Stats::enabled) {
+                Stats::onPush(storage.allocations());
+            }
+        }
+
+        void notePop() {
+            if constexpr (Stats::enabled) {
+                Stats::onPop(storage.allocations());
+            }
+        }
+
+        void noteReset() {
+            if constexpr (Stats::enabled) {
+                Stats::onReset(storage.size(), storage.allocations());
+            }
+        }
+
+    public:
+        // Конструктор по умолчанию
+        Queue() : storage() {}
+
+        // Конструктор с заданным аллокатором (например, std::pmr::polymorphic_allocator)
+        explicit Queue(const allocator_type& alloc) : storage(alloc) {}
+
+        // Конструктор с инициализатором списка
+        Queue(std::initializer_list<T> init_list, const allocator_type& alloc = allocator_type()) : Queue(alloc) {
+            push_range(init_list.begin(), init_list.end()); // Память выделяется сразу под весь список
+        }
+
+        // Конструктор копирования
+        Queue(const Queue& other) : Stats(), storage(other.storage) {
+            noteReset();
+        }
+
+        // Конструктор перемещения
+        Queue(Queue&& other) noexcept : Stats(), storage(std::move(other.storage)) {
+            noteReset();
+            other.noteReset();
+        }
+
+        // Оператор присваивания копированием
+        Queue& operator=(const Queue& other) {
+            if (this != &other) { // Защита от самоприсваивания
+                storage = other.storage;
+                noteReset();
+            }
+            return *this;
+        }
+
+        // Оператор присваивания перемещением
+        Queue& operator=(Queue&& other) noexcept(std::is_nothrow_move_assignable<Storage>::value) {
+            if (this != &other) {
+                storage = std::move(other.storage); // Исходная очередь остается пустой
+                noteReset();
+                other.noteReset();
+            }
+            return *this;
+        }
+
+        // Деструктор
+        ~Queue() {
+            clear(); // Удаляем все элементы
+        }
+
+        // Добавление элемента в конец очереди
+        void push(const T& value) {
+            storage.push_back(value);
+            notePush();
+        }
+
+        // Добавление элемента перемещением (без копирования)
+        void push(T&& value) {
+            storage.push_back(std::move(value));
+            notePush();
+        }
+
+        // Создание элемента прямо в очереди из аргументов конструктора T
+        template <typename... Args>
+        T& emplace(Args&&... args) {
+            T& value = storage.emplace_back(std::forward<Args>(args)...);
+            notePush();
+            return value;
+        }
+
+        // Добавление элементов диапазона [first, last); для прямых итераторов
+        // память резервируется заранее под весь диапазон
+        template <typename InputIt>
+        void push_range(InputIt first, InputIt last) {
+            using Category = typename std::iterator_traits<InputIt>::iterator_category;
+            if constexpr (std::is_base_of<std::forward_iterator_tag, Category>::value) {
+                storage.reserve(size() + static_cast<size_t>(std::distance(first, last)));
+            }
+            for (; first != last; ++first) {
+                storage.emplace_back(*first);
+                notePush();
+            }
+        }
+
+        // Добавление всех элементов контейнера
+        template <typename Range>
+        void push_range(Range&& range) {
+            using std::begin;
+            using std::end;
+            push_range(begin(range), end(range));
+        }
+
+        // Резервирование памяти минимум под n элементов
+        void reserve(size_t n) {
+            storage.reserve(n);
+        }
+
+        // Удаление элемента из начала очереди
+        void pop() {
+            if (empty()) {
+                throw CustomException("Queue is empty"); // Исключение, если очередь пуста
+            }
+            storage.pop_front();
+            notePop();
+        }
+
+        // Извлечение первого элемента перемещением в out
+        void pop_front(T& out) {
+            if (empty()) {
+                throw CustomException("Queue is empty"); // Исключение, если очередь пуста
+            }
+            out = std::move(storage.front_value());
+            storage.pop_front();
+            notePop();
+        }
+
+        // Извлечение первого элемента в out; false, если очередь пуста
+        bool try_pop(T& out) {
+            if (empty()) {
+                return false;
+            }
+            out = std::move(storage.front_value());
+            storage.pop_front();
+            notePop();
+            return true;
+        }
+
+        // Извлечение первого элемента без исключений: значение или QueueError::Empty
+        Result<T> try_pop() {
+            if (empty()) {
+                return QueueError::Empty;
+            }
+            Result<T> result(std::move(storage.front_value()));
+            storage.pop_front();
+            notePop();
+            return result;
+        }
+
+        // Извлечение до maxCount элементов в out; возвращает число извлеченных
+        template <typename OutputIt>
+        size_t pop_bulk(OutputIt out, size_t maxCount) {
+            size_t taken = 0;
+            for (; taken < maxCount && !empty(); ++taken, ++out) {
+                *out = std::move(storage.front_value());
+                storage.pop_front();
+                notePop();
+            }
+            return taken;
+        }
+
+        // Доступ к элементу по индексу (без удаления)
+        T& operator[](size_t index) {
+            if (index >= size()) {
+                throw CustomException("Index out of range"); // Исключение, если индекс вне диапазона
+            }
+            return storage.at(index);
+        }
+
+        // Доступ по индексу без исключений: ссылка или QueueError::OutOfRange
+        Result<T&> at_checked(size_t index) {
+            if (index >= size()) {
+                return QueueError::OutOfRange;
+            }
+            return storage.at(index);
+        }
+
+        // Возвращает аллокатор хранилища
+        allocator_type get_allocator() const {
+            return storage.get_allocator();
+        }
+
+        // Возвращает количество элементов в очереди
+        size_t size() const {
+            return storage.size();
+        }
+
+        // Проверяет, пуста ли очередь
+        bool empty() const {
+            return size() == 0;
+        }
+
+        // Удаляет все элементы из очереди
+        void clear() {
+            storage.clear();
+            noteReset();
+        }
+
+        // Снимок статистики (только для очередей с политикой QueueStats)
+        template <typename S = Stats, typename = std::enable_if_t<S::enabled>>
+        QueueStatsSnapshot stats() const {
+            return Stats::snapshot();
+        }
+
+        // Отображение всех элементов очереди
+        void display() const {
+            for (const T& value : *this) {
+                std::cout << value << " ";
+            }
+            std::cout << std::endl;
+        }
+
+        // Итераторы прямого обхода
+        iterator begin() { return storage.begin(); }
+        iterator end() { return storage.end(); }
+        const_iterator begin() const { return storage.begin(); }
+        const_iterator end() const { return storage.end(); }
+        const_iterator cbegin() const { return storage.begin(); }
+        const_iterator cend() const { return storage.end(); }
+
+        // Итераторы обратного обхода (память не выделяют)
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+        reverse_iterator rend() { return reverse_iterator(begin()); }
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+        const_reverse_iterator crbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator crend() const { return const_reverse_iterator(begin()); }
+    };
+
+    // Класс SpscQueue - ограниченная lock-free очередь для одного производителя
+    // и одного потребителя. Кольцо фиксированной емкости, индексы производителя
+    // и потребителя разнесены по разным кэш-линиям; синхронизация - только
+    // acquire/release на этих индексах. Каждая сторона кэширует индекс другой
+    // стороны и перечитывает его лишь тогда, когда кольцо кажется полным/пустым.
+    template <typename T>
+    class SpscQueue {
+    private:
+        static constexpr size_t cacheLine = 64; // Размер кэш-линии
+
+        T* slots;        // Кольцо элементов
+        size_t capacity; // Емкость (степень двойки)
+        size_t mask;     // capacity - 1
+
+        // Сторона потребителя
+        alignas(cacheLine) std::atomic<size_t> head; // Индекс следующего извлекаемого элемента
+        size_t cachedTail;                           // Последнее прочитанное значение tail
+
+        // Сторона производителя
+        alignas(cacheLine) std::atomic<size_t> tail; // Индекс следующей свободной ячейки
+        size_t cachedHead;                           // Последнее прочитанное значение head
+
+        static size_t roundUpCapacity(size_t n) {
+            size_t result = 2;
+            while (result < n) {
+                result *= 2;
+            }
+            return result;
+        }
+
+    public:
+        // Емкость округляется вверх до степени двойки
+        explicit SpscQueue(size_t minCapacity)
+            : slots(nullptr), capacity(roundUpCapacity(minCapacity)), mask(capacity - 1),
+              head(0), cachedTail(0), tail(0), cachedHead(0) {
+            slots = std::allocator<T>().allocate(capacity);
+        }
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        ~SpscQueue() {
+            size_t last = tail.load(std::memory_order_relaxed);
+            for (size_t i = head.load(std::memory_order_relaxed); i != last; ++i) {
+                slots[i & mask].~T();
+            }
+            std::allocator<T>().deallocate(slots, capacity);
+        }
+
+        // Добавление элемента (только поток-производитель); false, если очередь полна
+        template <typename U>
+        bool try_push(U&& value) {
+            size_t t = tail.load(std::memory_order_relaxed);
+            if (t - cachedHead == capacity) {
+                cachedHead = head.load(std::memory_order_acquire);
+                if (t - cachedHead == capacity) {
+                    return false;
+                }
+            }
+            new (slots + (t & mask)) T(std::forward<U>(value));
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Извлечение элемента (только поток-потребитель); false, если очередь пуста
+        bool try_pop(T& out) {
+            size_t h = head.load(std::memory_order_relaxed);
+            if (h == cachedTail) {
+                cachedTail = tail.load(std::memory_order_acquire);
+                if (h == cachedTail) {
+                    return false;
+                }
+            }
+            T& slot = slots[h & mask];
+            out = std::move(slot);
+            slot.~T();
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Добавление до n элементов из [first, first + n) с одной публикацией tail.
+        // Возвращает число добавленных элементов.
+        template <typename InputIt>
+        size_t try_push_batch(InputIt first, size_t n) {
+            size_t t = tail.load(std::memory_order_relaxed);
+            size_t space = capacity - (t - cachedHead);
+            if (space < n) {
+                cachedHead = head.load(std::memory_order_acquire);
+                space = capacity - (t - cachedHead);
+            }
+            size_t toPush = std::min(n, space);
+            for (size_t i = 0; i < toPush; ++i, ++first) {
+                new (slots + ((t + i) & mask)) T(*first);
+            }
+            tail.store(t + toPush, std::memory_order_release);
+            return toPush;
+        }
+
+        // Извлечение до maxCount элементов в out с одной публикацией head.
+        // Возвращает число извлеченных элементов.
+        template <typename OutputIt>
+        size_t try_pop_batch(OutputIt out, size_t maxCount) {
+            size_t h = head.load(std::memory_order_relaxed);
+            size_t available = cachedTail - h;
+            if (available < maxCount) {
+                cachedTail = tail.load(std::memory_order_acquire);
+                available = cachedTail - h;
+            }
+            size_t toPop = std::min(maxCount, available);
+            for (size_t i = 0; i < toPop; ++i, ++out) {
+                T& slot = slots[(h + i) & mask];
+                *out = std::move(slot);
+                slot.~T();
+            }
+            head.store(h + toPop, std::memory_order_release);
+            return toPop;
+        }
+
+        // Приблизительное число элементов (точное, если обе стороны простаивают)
+        size_t size() const {
+            return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+
+        size_t max_size() const {
+            return capacity;
+        }
+    };
+
+    // Класс ConcurrentQueue - потокобезопасная очередь для многих производителей
+    // и многих потребителей поверх Queue под одним мьютексом. Потребители могут
+    // ждать элементы (pop_wait/try_pop_for) и забирать пачку элементов за один
+    // захват мьютекса (try_pop_bulk/pop_bulk_wait). После close() новые элементы
+    // не принимаются, а ожидающие потребители просыпаются, как только очередь опустеет.
+    template <typename T, typename Storage = RingStorage<T>>
+    class ConcurrentQueue {
+    private:
+        Queue<T, Storage> queue;           // Элементы очереди
+        mutable std::mutex lock;           // Защищает queue и closed
+        std::condition_variable available; // Сигнал о новом элементе или закрытии
+        size_t waiting;                    // Число потребителей, ждущих на available
+        bool closed;                       // Очередь закрыта для push
+
+        template <typename U>
+        bool pushImpl(U&& value) {
+            bool wake;
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                if (closed) {
+                    return false;
+                }
+                queue.push(std::forward<U>(value));
+                wake = waiting > 0;
+            }
+            if (wake) {
+                available.notify_one(); // Будим только если кто-то действительно ждет
+            }
+            return true;
+        }
+
+    public:
+        ConcurrentQueue() : waiting(0), closed(false) {}
+
+        ConcurrentQueue(const ConcurrentQueue&) = delete;
+        ConcurrentQueue& operator=(const ConcurrentQueue&) = delete;
+
+        // Добавление элемента; false, если очередь уже закрыта
+        bool push(const T& value) {
+            return pushImpl(value);
+        }
+
+        bool push(T&& value) {
+            return pushImpl(std::move(value));
+        }
+
+        // Извлечение без ожидания; false, если очередь пуста
+        bool try_pop(T& out) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (queue.empty()) {
+                return false;
+            }
+            queue.pop_front(out);
+            return true;
+        }
+
+        // Извлечение с ожиданием; false, если очередь закрыта и пуста
+        bool pop_wait(T& out) {
+            std::unique_lock<std::mutex> guard(lock);
+            ++waiting;
+            available.wait(guard, [this] { return !queue.empty() || closed; });
+            --waiting;
+            if (queue.empty()) {
+                return false;
+            }
+            queue.pop_front(out);
+            return true;
+        }
+
+        // Извлечение с ожиданием не дольше timeout; false по таймауту или после закрытия
+        template <typename Rep, typename Period>
+        bool try_pop_for(T& out, const std::chrono::duration<Rep, Period>& timeout) {
+            std::unique_lock<std::mutex> guard(lock);
+            ++waiting;
+            bool ready = available.wait_for(guard, timeout, [this] { return !queue.empty() || closed; });
+            --waiting;
+            if (!ready || queue.empty()) {
+                return false;
+            }
+            queue.pop_front(out);
+            return true;
+        }
+
+        // Извлечение до maxCount элементов за один захват мьютекса без ожидания
+        template <typename OutputIt>
+        size_t try_pop_bulk(OutputIt out, size_t maxCount) {
+            std::lock_guard<std::mutex> guard(lock);
+            return queue.pop_bulk(out, maxCount);
+        }
+
+        // Как try_pop_bulk, но ждет хотя бы одного элемента; 0 - очередь закрыта и пуста
+        template <typename OutputIt>
+        size_t pop_bulk_wait(OutputIt out, size_t maxCount) {
+            std::unique_lock<std::mutex> guard(lock);
+            ++waiting;
+            available.wait(guard, [this] { return !queue.empty() || closed; });
+            --waiting;
+            return queue.pop_bulk(out, maxCount);
+        }
+
+        // Закрытие очереди: push перестает принимать элементы, ожидающие просыпаются
+        void close() {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                closed = true;
+            }
+            available.notify_all();
+        }
+
+        bool is_closed() const {
+            std::lock_guard<std::mutex> guard(lock);
+            return closed;
+        }
+
+        size_t size() const {
+            std::lock_guard<std::mutex> guard(lock);
+            return queue.size();
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+    };
+
+    // Класс WorkStealingDeque - дек Чейза-Лева для планировщика с кражей задач.
+    // Владелец кладет и забирает элементы с нижнего конца без блокировок,
+    // остальные потоки крадут с верхнего конца через CAS. Кольцо растет
+    // удвоением; старые кольца живут до уничтожения дека, так как вор мог
+    // успеть прочитать указатель на них.
+    template <typename T>
+    class WorkStealingDeque {
+        static_assert(std::is_trivially_copyable<T>::value, "WorkStealingDeque stores T in atomics");
+
+    private:
+        // Кольцевой массив фиксированной емкости
+        struct Ring {
+            long long capacity;
+            long long mask;
+            std::unique_ptr<std::atomic<T>[]> items;
+            std::unique_ptr<Ring> previous; // Предыдущее (меньшее) кольцо
+
+            explicit Ring(long long cap) : capacity(cap), mask(cap - 1), items(new std::atomic<T>[cap]) {}
+
+            T get(long long i) const { return items[i & mask].load(std::memory_order_relaxed); }
+            void put(long long i, T value) { items[i & mask].store(value, std::memory_order_relaxed); }
+        };
+
+        alignas(64) std::atomic<long long> top;    // Конец для воров
+        alignas(64) std::atomic<long long> bottom; // Конец владельца
+        std::atomic<Ring*> ring;                   // Текущее кольцо
+
+    public:
+        explicit WorkStealingDeque(long long capacity = 1024) : top(0), bottom(0) {
+            long long cap = 2;
+            while (cap < capacity) {
+                cap *= 2;
+            }
+            ring.store(new Ring(cap), std::memory_order_relaxed);
+        }
+
+        WorkStealingDeque(const WorkStealingDeque&) = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+        ~WorkStealingDeque() {
+            delete ring.load(std::memory_order_relaxed); // Вместе с цепочкой предыдущих колец
+        }
+
+        // Добавление в нижний конец (только владелец)
+        void push(T value) {
+            long long b = bottom.load(std::memory_order_relaxed);
+            long long t = top.load(std::memory_order_acquire);
+            Ring* current = ring.load(std::memory_order_relaxed);
+            if (b - t > current->capacity - 1) {
+                current = grow(current, t, b);
+            }
+            current->put(b, value);
+            bottom.store(b + 1, std::memory_order_release); // Публикуем элемент для воров
+        }
+
+        // Извлечение из нижнего конца (только владелец); false, если дек пуст
+        bool pop(T& out) {
+            long long b = bottom.load(std::memory_order_relaxed) - 1;
+            Ring* current = ring.load(std::memory_order_relaxed);
+            bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            long long t = top.load(std::memory_order_relaxed);
+
+            if (t > b) {
+                bottom.store(b + 1, std::memory_order_relaxed); // Дек был пуст
+                return false;
+            }
+            out = current->get(b);
+            if (t == b) {
+                // Последний элемент - соревнуемся с ворами
+                bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return won;
+            }
+            return true;
+        }
+
+        // Кража из верхнего конца (любой поток); false, если дек пуст или кража проиграна
+        bool steal(T& out) {
+            long long t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            long long b = bottom.load(std::memory_order_acquire);
+            if (t >= b) {
+                return false;
+            }
+            T value = ring.load(std::memory_order_acquire)->get(t);
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return false;
+            }
+            out = value;
+            return true;
+        }
+
+        // Приблизительное число элементов
+        size_t size() const {
+            long long b = bottom.load(std::memory_order_relaxed);
+            long long t = top.load(std::memory_order_relaxed);
+            return b > t ? static_cast<size_t>(b - t) : 0;
+        }
+
+    private:
+        Ring* grow(Ring* current, long long t, long long b) {
+            Ring* bigger = new Ring(current->capacity * 2);
+            for (long long i = t; i < b; ++i) {
+                bigger->put(i, current->get(i));
+            }
+            bigger->previous.reset(current);
+            ring.store(bigger, std::memory_order_release);
+            return bigger;
+        }
+    };
+
+    // Класс Executor - пул потоков с кражей задач. У каждого рабочего потока
+    // свой WorkStealingDeque; задачи, отправленные извне пула, попадают в общую
+    // ConcurrentQueue. Поток без работы крадет у случайно выбранной жертвы.
+    // Ожидание результата через wait() внутри задачи не блокирует поток:
+    // пока результат не готов, он выполняет другие задачи (fork/join).
+    class Executor {
+    private:
+        // Задача с удаленным типом
+        struct Task {
+            virtual ~Task() = default;
+            virtual void run() = 0;
+        };
+
+        template <typename F>
+        struct TaskImpl : Task {
+            F func;
+            explicit TaskImpl(F&& f) : func(std::move(f)) {}
+            void run() override { func(); }
+        };
+
+        // Состояние рабочего потока
+        struct Worker {
+            WorkStealingDeque<Task*> deque;
+            unsigned long long randomState; // Состояние xorshift для выбора жертвы
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::vector<std::thread> threads;
+        ConcurrentQueue<Task*> injected; // Задачи от потоков вне пула
+
+        std::mutex sleepLock;
+        std::condition_variable wakeUp;
+        std::atomic<size_t> sleepers;
+        std::atomic<bool> stopping;
+
+        // Рабочий поток, выполняющий текущий код (nullptr вне пула)
+        static inline thread_local Worker* currentWorker = nullptr;
+        static inline thread_local const Executor* currentExecutor = nullptr;
+
+        Worker* localWorker() const {
+            return currentExecutor == this ? currentWorker : nullptr;
+        }
+
+        void schedule(Task* task) {
+            if (Worker* self = localWorker()) {
+                self->deque.push(task);
+            } else {
+                injected.push(task);
+            }
+            if (sleepers.load(std::memory_order_acquire) > 0) {
+                std::lock_guard<std::mutex> guard(sleepLock);
+                wakeUp.notify_one();
+            }
+        }
+
+        // Поиск задачи: свой дек, затем общая очередь, затем кража у случайной жертвы
+        Task* findTask(Worker* self) {
+            Task* task = nullptr;
+            if (self && self->deque.pop(task)) {
+                return task;
+            }
+            if (injected.try_pop(task)) {
+                return task;
+            }
+            size_t n = workers.size();
+            unsigned long long& state = self ? self->randomState : fallbackRandom();
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            size_t start = static_cast<size_t>(state % n);
+            for (size_t i = 0; i < n; ++i) {
+                Worker* victim = workers[(start + i) % n].get();
+                if (victim != self && victim->deque.steal(task)) {
+                    return task;
+                }
+            }
+            return nullptr;
+        }
+
+        static unsigned long long& fallbackRandom() {
+            static thread_local unsigned long long state =
+                0x9E3779B97F4A7C15ull ^ std::hash<std::thread::id>()(std::this_thread::get_id());
+            return state;
+        }
+
+        static void execute(Task* task) {
+            std::unique_ptr<Task> owned(task);
+            owned->run();
+        }
+
+        void workerLoop(Worker* self) {
+            currentWorker = self;
+            currentExecutor = this;
+            while (!stopping.load(std::memory_order_acquire)) {
+                if (Task* task = findTask(self)) {
+                    execute(task);
+                    continue;
+                }
+                // Работы нет - засыпаем; таймаут страхует от пропущенного сигнала
+                std::unique_lock<std::mutex> guard(sleepLock);
+                sleepers.fetch_add(1, std::memory_order_acq_rel);
+                wakeUp.wait_for(guard, std::chrono::milliseconds(1));
+                sleepers.fetch_sub(1, std::memory_order_acq_rel);
+            }
+        }
+
+    public:
+        // threadCount = 0 - по числу аппаратных потоков
+        explicit Executor(size_t threadCount = 0) : sleepers(0), stopping(false) {
+            if (threadCount == 0) {
+                threadCount = std::max(1u, std::thread::hardware_concurrency());
+            }
+            for (size_t i = 0; i < threadCount; ++i) {
+                workers.emplace_back(new Worker{WorkStealingDeque<Task*>(), 0x2545F4914F6CDD1Dull * (i + 1)});
+            }
+            for (size_t i = 0; i < threadCount; ++i) {
+                threads.emplace_back(&Executor::workerLoop, this, workers[i].get());
+            }
+        }
+
+        Executor(const Executor&) = delete;
+        Executor& operator=(const Executor&) = delete;
+
+        // Останавливает потоки; невыполненные задачи уничтожаются (их future получают broken_promise)
+        ~Executor() {
+            stopping.store(true, std::memory_order_release);
+            {
+                std::lock_guard<std::mutex> guard(sleepLock);
+                wakeUp.notify_all();
+            }
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+            Task* task = nullptr;
+            for (auto& worker : workers) {
+                while (worker->deque.pop(task)) {
+                    delete task;
+                }
+            }
+            while (injected.try_pop(task)) {
+                delete task;
+            }
+        }
+
+        size_t size() const {
+            return workers.size();
+        }
+
+        // Отправка задачи на выполнение; результат - через future
+        template <typename F>
+        auto submit(F&& func) -> std::future<decltype(func())> {
+            using Result = decltype(func());
+            std::packaged_task<Result()> packaged(std::forward<F>(func));
+            std::future<Result> result = packaged.get_future();
+            schedule(new TaskImpl<std::packaged_task<Result()>>(std::move(packaged)));
+            return result;
+        }
+
+        // Ожидание результата; пока он не готов, текущий поток выполняет другие задачи
+        template <typename R>
+        R wait(std::future<R>& result) {
+            Worker* self = localWorker();
+            while (result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                if (Task* task = findTask(self)) {
+                    execute(task);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            return result.get();
+        }
+
+        // Параллельный цикл body(i) для i из [first, last); grain - минимальный размер куска
+        template <typename F>
+        void parallel_for(size_t first, size_t last, F body, size_t grain = 0) {
+            if (first >= last) {
+                return;
+            }
+            size_t total = last - first;
+            if (grain == 0) {
+                grain = std::max<size_t>(1, total / (workers.size() * 8)); // Около 8 кусков на поток
+            }
+            std::vector<std::future<void>> parts;
+            for (size_t begin = first; begin < last; begin += grain) {
+                size_t end = std::min(last, begin + grain);
+                parts.push_back(submit([&body, begin, end] {
+                    for (size_t i = begin; i < end; ++i) {
+                        body(i);
+                    }
+                }));
+            }
+            // Все куски дожидаются даже после ошибки: они ссылаются на body,
+            // который живет только до выхода из функции
+            std::exception_ptr error;
+            for (auto& part : parts) {
+                try {
+                    wait(part);
+                } catch (...) {
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    };
+
+#ifdef CONTAINERS_HAS_MMAP
+    // Правила записи элемента в сегмент SpillingQueue: фиксированный размер
+    // записи, запись и чтение из сырой памяти. Для тривиально копируемых типов -
+    // побайтовая копия; для остальных типов нужна своя специализация.
+    template <typename T, typename Enable = void>
+    struct SpillTraits;
+
+    template <typename T>
+    struct SpillTraits<T, std::enable_if_t<std::is_trivially_copyable<T>::value>> {
+        static constexpr size_t recordSize = sizeof(T);
+
+        static void write(const T& value, unsigned char* place) {
+            std::memcpy(place, &value, sizeof(T));
+        }
+
+        static T read(const unsigned char* place) {
+            T value;
+            std::memcpy(&value, place, sizeof(T));
+            return value;
+        }
+    };
+
+    // Класс SpillingQueue - очередь, переживающая всплески больше объема памяти.
+    // В памяти держатся только голова (старейшие элементы) и хвост (новейшие),
+    // каждый не больше memoryElements; середина сбрасывается в каталог в виде
+    // сегментов фиксированного размера, отображенных в память (mmap). Прочитанные
+    // сегменты остаются на диске до следующего sync() и только потом
+    // переименовываются для повторного использования. sync() (и деструктор)
+    // сохраняет голову и метаданные одним файлом queue.state, подменяемым
+    // единственным rename, поэтому после перезапуска очередь открывается с того
+    // же места; элементы, извлеченные после последнего sync(), при этом будут
+    // выданы повторно.
+    template <typename T, typename Traits = SpillTraits<T>>
+    class SpillingQueue {
+    private:
+        static constexpr size_t recordSize = Traits::recordSize;
+        static constexpr size_t maxSpareSegments = 4; // Сколько прочитанных сегментов держать про запас
+
+        // Отображение одного сегмента в память
+        struct Mapping {
+            int fd = -1;
+            unsigned char* data = nullptr;
+            unsigned long long segment = 0; // Номер сегмента
+        };
+
+        std::string directory;
+        size_t memoryElements;    // Предельный размер головы и хвоста в памяти
+        size_t recordsPerSegment; // Элементов в одном сегменте
+        size_t segmentBytes;      // Размер файла сегмента
+
+        Queue<T, RingStorage<T>> head; // Старейшие элементы
+        Queue<T, RingStorage<T>> tail; // Новейшие элементы, еще не сброшенные на диск
+
+        // Элементы на диске занимают сегменты [firstSegment, lastSegment]
+        size_t diskCount;
+        unsigned long long firstSegment;
+        unsigned long long lastSegment;
+        size_t readOffset;  // Прочитано записей в firstSegment
+        size_t writeOffset; // Записано записей в lastSegment
+
+        Mapping readMap;
+        Mapping writeMap;
+        std::vector<std::string> spareSegments; // Прочитанные файлы для повторного использования
+        // Прочитанные после последнего sync() сегменты: сохраненные метаданные еще
+        // ссылаются на них, поэтому до sync() они не трогаются
+        std::vector<unsigned long long> retiredSegments;
+
+        // error - errno сразу после неудачного системного вызова, до close и
+        // других вызовов, которые могут его перезаписать
+        static void fail(const std::string& what, int error) {
+            throw CustomException("SpillingQueue: " + what + ": " + std::strerror(error));
+        }
+
+        std::string segmentPath(unsigned long long segment) const {
+            char name[40];
+            std::snprintf(name, sizeof(name), "/segment-%016llu.dat", segment);
+            return directory + name;
+        }
+
+        // Метаданные текстовой строкой, за ней голова очереди записями по recordSize
+        std::string statePath() const { return directory + "/queue.state"; }
+
+        void unmap(Mapping& map) {
+            if (map.data) {
+                munmap(map.data, segmentBytes);
+                close(map.fd);
+            }
+            map = Mapping();
+        }
+
+        // Отображение сегмента; create - новый файл (по возможности из запасных),
+        // иначе существующий сегмент полного размера
+        void mapSegment(Mapping& map, unsigned long long segment, bool create) {
+            unmap(map);
+            std::string path = segmentPath(segment);
+            if (create && !spareSegments.empty()) {
+                if (std::rename(spareSegments.back().c_str(), path.c_str()) != 0) {
+                    fail("rename " + spareSegments.back(), errno);
+                }
+                spareSegments.pop_back();
+            }
+            int fd = open(path.c_str(), create ? O_RDWR | O_CREAT : O_RDWR, 0644);
+            if (fd < 0) {
+                fail("open " + path, errno);
+            }
+            if (create && ftruncate(fd, static_cast<off_t>(segmentBytes)) != 0) {
+                int error = errno;
+                close(fd);
+                fail("ftruncate " + path, error);
+            }
+            struct stat info;
+            if (!create && fstat(fd, &info) != 0) {
+                int error = errno;
+                close(fd);
+                fail("fstat " + path, error);
+            }
+            if (!create && static_cast<size_t>(info.st_size) < segmentBytes) {
+                close(fd);
+                fail("short segment " + path, EINVAL);
+            }
+            void* data = mmap(nullptr, segmentBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (data == MAP_FAILED) {
+                int error = errno;
+                close(fd);
+                fail("mmap " + path, error);
+            }
+            madvise(data, segmentBytes, MADV_SEQUENTIAL);
+            map.fd = fd;
+            map.data = static_cast<unsigned char*>(data);
+            map.segment = segment;
+        }
+
+        // Прочитанный сегмент откладывается до sync()
+        void retireSegment(unsigned long long segment) {
+            if (readMap.data && readMap.segment == segment) {
+                unmap(readMap);
+            }
+            if (writeMap.data && writeMap.segment == segment) {
+                unmap(writeMap);
+            }
+            retiredSegments.push_back(segment);
+        }
+
+        // Сегмент, на который сохраненные метаданные больше не ссылаются, уходит
+        // в запас (или удаляется, если запас полон)
+        void recycleSegment(unsigned long long segment) {
+            std::string path = segmentPath(segment);
+            if (spareSegments.size() < maxSpareSegments) {
+                std::string spare = directory + "/spare-" + std::to_string(segment) + ".dat";
+                if (std::rename(path.c_str(), spare.c_str()) == 0) {
+                    spareSegments.push_back(spare);
+                    return;
+                }
+            }
+            std::remove(path.c_str());
+        }
+
+        void writeRecord(const T& value) {
+            if (diskCount == 0 && !writeMap.data) {
+                // Диск пуст - начинаем новый сегмент
+                firstSegment = lastSegment = lastSegment + 1;
+                readOffset = writeOffset = 0;
+                mapSegment(writeMap, lastSegment, true);
+            } else if (writeOffset == recordsPerSegment) {
+                ++lastSegment;
+                writeOffset = 0;
+                mapSegment(writeMap, lastSegment, true);
+            } else if (!writeMap.data) {
+                mapSegment(writeMap, lastSegment, false); // После перезапуска
+            }
+            Traits::write(value, writeMap.data + writeOffset * recordSize);
+            ++writeOffset;
+            ++diskCount;
+        }
+
+        T readRecord() {
+            const unsigned char* data;
+            if (writeMap.data && writeMap.segment == firstSegment) {
+                data = writeMap.data; // Читаем из сегмента, который еще дописывается
+            } else {
+                if (!readMap.data || readMap.segment != firstSegment) {
+                    mapSegment(readMap, firstSegment, false);
+                }
+                data = readMap.data;
+            }
+            T value = Traits::read(data + readOffset * recordSize);
+            ++readOffset;
+            --diskCount;
+            if (diskCount == 0) {
+                retireSegment(firstSegment); // firstSegment == lastSegment
+                readOffset = writeOffset = 0;
+            } else if (readOffset == recordsPerSegment) {
+                retireSegment(firstSegment);
+                ++firstSegment;
+                readOffset = 0;
+            }
+            return value;
+        }
+
+        // Сброс хвоста на диск
+        void spillTail() {
+            T value;
+            while (tail.try_pop(value)) {
+                writeRecord(value);
+            }
+        }
+
+        // Пополнение пустой головы: сначала с диска, иначе весь хвост целиком
+        void refillHead() {
+            if (diskCount > 0) {
+                for (size_t i = 0; i < memoryElements && diskCount > 0; ++i) {
+                    head.push(readRecord());
+                }
+            } else {
+                head = std::move(tail);
+            }
+        }
+
+        void loadState() {
+            std::ifstream state(statePath(), std::ios::binary);
+            if (!state) {
+                return; // Новая очередь
+            }
+            std::string header;
+            std::getline(state, header);
+            size_t storedRecordSize = 0, headCount = 0;
+            int fields = std::sscanf(header.c_str(), "SPILLQ2 %zu %zu %llu %llu %zu %zu %zu %zu", &storedRecordSize,
+                                     &recordsPerSegment, &firstSegment, &lastSegment, &readOffset, &writeOffset,
+                                     &diskCount, &headCount);
+            if (!state || fields != 8 || storedRecordSize != recordSize || recordsPerSegment == 0) {
+                throw CustomException("SpillingQueue: incompatible metadata in " + statePath());
+            }
+            segmentBytes = recordsPerSegment * recordSize;
+
+            std::vector<unsigned char> record(recordSize);
+            for (size_t i = 0; i < headCount; ++i) {
+                if (!state.read(reinterpret_cast<char*>(record.data()), recordSize)) {
+                    throw CustomException("SpillingQueue: truncated " + statePath());
+                }
+                head.push(Traits::read(record.data()));
+            }
+        }
+
+        // Запись size байт целиком; false - ошибка, причина в errno
+        static bool writeAll(int fd, const char* data, size_t size) {
+            while (size > 0) {
+                ssize_t written = ::write(fd, data, size);
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return false;
+                }
+                data += written;
+                size -= static_cast<size_t>(written);
+            }
+            return true;
+        }
+
+    public:
+        // directory должен существовать; segmentBytes округляется вниз до целого числа записей
+        explicit SpillingQueue(const std::string& dir, size_t memoryLimit = 1 << 16, size_t segmentSize = 64 << 20)
+            : directory(dir), memoryElements(std::max<size_t>(1, memoryLimit)),
+              recordsPerSegment(std::max<size_t>(1, segmentSize / recordSize)),
+              segmentBytes(recordsPerSegment * recordSize),
+              diskCount(0), firstSegment(0), lastSegment(0), readOffset(0), writeOffset(0) {
+            loadState();
+            head.reserve(memoryElements);
+            tail.reserve(memoryElements);
+        }
+
+        SpillingQueue(const SpillingQueue&) = delete;
+        SpillingQueue& operator=(const SpillingQueue&) = delete;
+
+        ~SpillingQueue() {
+            try {
+                sync();
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << std::endl; // Деструктор не должен бросать исключения
+            }
+            unmap(readMap);
+            unmap(writeMap);
+            for (const std::string& spare : spareSegments) {
+                std::remove(spare.c_str());
+            }
+        }
+
+        void push(const T& value) {
+            if (diskCount == 0 && tail.empty() && head.size() < memoryElements) {
+                head.push(value); // Очередь целиком помещается в голову
+                return;
+            }
+            tail.push(value);
+            if (tail.size() >= memoryElements) {
+                spillTail();
+            }
+        }
+
+        // Извлечение первого элемента в out; false, если очередь пуста
+        bool try_pop(T& out) {
+            if (head.empty()) {
+                refillHead();
+            }
+            return head.try_pop(out);
+        }
+
+        // Извлечение первого элемента в out
+        void pop_front(T& out) {
+            if (!try_pop(out)) {
+                throw CustomException("Queue is empty");
+            }
+        }
+
+        size_t size() const {
+            return head.size() + diskCount + tail.size();
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+
+        // Число элементов, лежащих на диске
+        size_t spilled() const {
+            return diskCount;
+        }
+
+        // Сохранение состояния: хвост уходит на диск, голова и метаданные - в файлы каталога
+        void sync() {
+            spillTail();
+            if (writeMap.data && msync(writeMap.data, segmentBytes, MS_SYNC) != 0) {
+                fail("msync " + segmentPath(writeMap.segment), errno);
+            }
+
+            // Метаданные и голова - в одном файле: единственный rename ниже и есть
+            // точка фиксации, метаданные от одного sync() с головой от другого не
+            // смешаются
+            char header[200];
+            int headerSize = std::snprintf(header, sizeof(header), "SPILLQ2 %zu %zu %llu %llu %zu %zu %zu %zu\n",
+                                           recordSize, recordsPerSegment, firstSegment, lastSegment, readOffset,
+                                           writeOffset, diskCount, head.size());
+            std::vector<char> contents(header, header + headerSize);
+            contents.resize(contents.size() + head.size() * recordSize);
+            unsigned char* place = reinterpret_cast<unsigned char*>(contents.data()) + headerSize;
+            for (const T& value : head) {
+                Traits::write(value, place);
+                place += recordSize;
+            }
+
+            std::string stateTmp = statePath() + ".tmp";
+            int fd = open(stateTmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0) {
+                fail("open " + stateTmp, errno);
+            }
+            if (!writeAll(fd, contents.data(), contents.size()) || fsync(fd) != 0) {
+                int error = errno;
+                close(fd);
+                fail("write " + stateTmp, error);
+            }
+            if (close(fd) != 0) {
+                fail("close " + stateTmp, errno);
+            }
+            if (std::rename(stateTmp.c_str(), statePath().c_str()) != 0) {
+                fail("rename " + stateTmp, errno);
+            }
+            // rename становится постоянным только после fsync каталога
+            int dirFd = open(directory.c_str(), O_RDONLY);
+            if (dirFd >= 0) {
+                fsync(dirFd);
+                close(dirFd);
+            }
+            // Новые метаданные сохранены - прочитанные сегменты больше не нужны
+            for (unsigned long long segment : retiredSegments) {
+                recycleSegment(segment);
+            }
+            retiredSegments.clear();
+        }
+    };
+#endif
+
+    // Очереди, память которых берется из std::pmr::memory_resource
+    namespace pmr {
+        template <typename T>
+        using NodeStorage = containers::NodeStorage<T, std::pmr::polymorphic_allocator<T>>;
+
+        template <typename T>
+        using RingStorage = containers::RingStorage<T, std::pmr::polymorphic_allocator<T>>;
+
+        template <typename T, typename Storage = NodeStorage<T>, typename Stats = NoStats>
+        using Queue = containers::Queue<T, Storage, Stats>;
+    } // namespace pmr
+} // namespace containers
+
+// Замер среднего времени одной операции (в наносекундах)
+template <typename F>
+double measureNsPerOp(size_t ops, F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto finish = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(finish - start).count() / static_cast<double>(ops);
+}
+
+// Сравнение хранилищ на операциях push/pop/operator[]
+template <typename T, typename Storage>
+void benchmarkStorage(const char* name, const T& sample, size_t n, size_t indexN) {
+    using namespace containers;
+    volatile size_t sink = 0; // Не дает компилятору выбросить результат
+
+    Queue<T, Storage> queue;
+    double pushNs = measureNsPerOp(n, [&] {
+        for (size_t i = 0; i < n; ++i) {
+            queue.push(sample);
+        }
+    });
+    double popNs = measureNsPerOp(n, [&] {
+        for (size_t i = 0; i < n; ++i) {
+            queue.pop();
+        }
+    });
+
+    for (size_t i = 0; i < indexN; ++i) {
+        queue.push(sample);
+    }
+    double indexNs = measureNsPerOp(indexN, [&] {
+        for (size_t i = 0; i < indexN; ++i) {
+            sink = sink + reinterpret_cast<size_t>(&queue[i]);
+        }
+    });
+
+    std::cout << name << ": push " << pushNs << " ns, pop " << popNs
+              << " ns, operator[] " << indexNs << " ns (n = " << indexN << ")" << std::endl;
+}
+
+void runStorageBenchmark() {
+    using namespace containers;
+    const size_t n = 1000000;
+    const std::string text = "benchmark string value"; // Не помещается в SSO
+
+    benchmarkStorage<int, NodeStorage<int>>("int    Node", 42, n, 10000);
+    benchmarkStorage<int, RingStorage<int>>("int    Ring", 42, n, n);
+    benchmarkStorage<std::string, NodeStorage<std::string>>("string Node", text, n, 10000);
+    benchmarkStorage<std::string, RingStorage<std::string>>("string Ring", text, n, n);
+}
+
+// Ресурс памяти, подсчитывающий обращения к вышестоящему ресурсу
+class CountingResource : public std::pmr::memory_resource {
+private:
+    std::pmr::memory_resource* upstream = std::pmr::new_delete_resource();
+
+public:
+    size_t allocations = 0;   // Число вызовов allocate
+    size_t deallocations = 0; // Число вызовов deallocate
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++allocations;
+        return upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        ++deallocations;
+        upstream->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// Число обращений к аллокатору при чередовании push/pop в установившемся режиме
+template <typename T>
+void benchmarkNodePool(const char* name, const T& sample, size_t depth, size_t ops) {
+    CountingResource resource;
+    containers::pmr::Queue<T> queue(&resource);
+
+    for (size_t i = 0; i < depth; ++i) {
+        queue.push(sample); // Прогрев: очередь достигает рабочей глубины
+    }
+    size_t warmAllocations = resource.allocations;
+
+    double ns = measureNsPerOp(ops, [&] {
+        for (size_t i = 0; i < ops; ++i) {
+            queue.push(sample);
+            queue.pop();
+        }
+    });
+    size_t churnAllocations = resource.allocations - warmAllocations;
+
+    queue.clear();
+    std::cout << name << ": push+pop " << ns << " ns, allocations per op "
+              << static_cast<double>(churnAllocations) / static_cast<double>(ops)
+              << " (warm-up " << warmAllocations << ", slabs freed by clear " << resource.deallocations << ")"
+              << std::endl;
+}
+
+// swap уносит счетчик обращений к аллокатору вместе с памятью, на которую он
+// приходится
+template <typename Storage>
+bool checkSwapAllocations() {
+    Storage filled;
+    Storage empty;
+    for (int i = 0; i < 10000; ++i) {
+        filled.push_back(i);
+    }
+    size_t allocations = filled.allocations();
+    filled.swap(empty);
+    return allocations > 0 && empty.allocations() == allocations && filled.allocations() == 0;
+}
+
+void runNodePoolBenchmark() {
+    const std::string text = "benchmark string value";
+    benchmarkNodePool<int>("int    pool", 42, 1000, 1000000);
+    benchmarkNodePool<std::string>("string pool", text, 1000, 1000000);
+
+    bool swapOk = checkSwapAllocations<containers::NodeStorage<int>>() &&
+                  checkSwapAllocations<containers::RingStorage<int>>();
+    std::cout << "swap keeps allocation counts: " << (swapOk ? "ok" : "BROKEN") << std::endl;
+}
+
+// Двухпоточная проверка SpscQueue: потребитель должен получить 0..n-1 строго по порядку.
+// Возвращает true, если ни одно значение не потеряно и не переставлено.
+bool stressSpscQueue(size_t n, size_t capacity, size_t batch) {
+    containers::SpscQueue<size_t> queue(capacity);
+    bool ok = true;
+
+    std::thread producer([&] {
+        std::vector<size_t> chunk(batch);
+        size_t next = 0;
+        while (next < n) {
+            if (batch <= 1) {
+                if (queue.try_push(next)) {
+                    ++next;
+                } else {
+                    std::this_thread::yield();
+                }
+                continue;
+            }
+            size_t len = std::min(batch, n - next);
+            for (size_t i = 0; i < len; ++i) {
+                chunk[i] = next + i;
+            }
+            size_t pushed = queue.try_push_batch(chunk.begin(), len);
+            next += pushed;
+            if (pushed == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::vector<size_t> received(std::max<size_t>(batch, 1));
+    size_t expected = 0;
+    while (expected < n) {
+        size_t got = batch <= 1 ? (queue.try_pop(received[0]) ? 1 : 0)
+                                : queue.try_pop_batch(received.begin(), batch);
+        for (size_t i = 0; i < got; ++i) {
+            if (received[i] != expected++) {
+                ok = false;
+            }
+        }
+        if (got == 0) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    return ok && queue.empty();
+}
+
+// Пропускная способность передачи n чисел между двумя потоками
+template <typename PushFn, typename PopFn>
+double measureHandoff(size_t n, PushFn push, PopFn pop) {
+    auto start = std::chrono::steady_clock::now();
+    std::thread producer([&] {
+        for (size_t i = 0; i < n; ++i) {
+            while (!push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    size_t value = 0;
+    for (size_t i = 0; i < n; ++i) {
+        while (!pop(value)) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    auto finish = std::chrono::steady_clock::now();
+    return static_cast<double>(n) / std::chrono::duration<double>(finish - start).count();
+}
+
+void runSpscBenchmark() {
+    using namespace containers;
+    const size_t n = 10000000;
+
+    SpscQueue<size_t> spsc(1024);
+    double spscRate = measureHandoff(n,
+        [&](size_t v) { return spsc.try_push(v); },
+        [&](size_t& v) { return spsc.try_pop(v); });
+
+    // Существующая очередь под мьютексом
+    Queue<size_t> locked;
+    std::mutex lock;
+    double mutexRate = measureHandoff(n,
+        [&](size_t v) {
+            std::lock_guard<std::mutex> guard(lock);
+            locked.push(v);
+            return true;
+        },
+        [&](size_t& v) {
+            std::lock_guard<std::mutex> guard(lock);
+            return locked.try_pop(v);
+        });
+
+    std::cout << "SpscQueue:           " << spscRate / 1e6 << " M items/s" << std::endl;
+    std::cout << "Queue + std::mutex:  " << mutexRate / 1e6 << " M items/s" << std::endl;
+}
+
+// Нагрузочный тест ConcurrentQueue: threads производителей и threads потребителей.
+// Возвращает суммарную пропускную способность (операций push+pop в секунду).
+double measureConcurrentQueue(size_t threads, size_t itemsPerProducer, size_t batch) {
+    containers::ConcurrentQueue<size_t> queue;
+    std::atomic<size_t> consumedSum(0);
+    std::atomic<size_t> consumedCount(0);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (size_t p = 0; p < threads; ++p) {
+        workers.emplace_back([&queue, itemsPerProducer] {
+            for (size_t i = 1; i <= itemsPerProducer; ++i) {
+                queue.push(i);
+            }
+        });
+    }
+    for (size_t c = 0; c < threads; ++c) {
+        workers.emplace_back([&queue, &consumedSum, &consumedCount, batch] {
+            std::vector<size_t> items(batch);
+            size_t sum = 0;
+            size_t count = 0;
+            for (;;) {
+                size_t got = queue.pop_bulk_wait(items.begin(), batch);
+                if (got == 0) {
+                    break; // Очередь закрыта и пуста
+                }
+                for (size_t i = 0; i < got; ++i) {
+                    sum += items[i];
+                }
+                count += got;
+            }
+            consumedSum += sum;
+            consumedCount += count;
+        });
+    }
+    for (size_t p = 0; p < threads; ++p) {
+        workers[p].join();
+    }
+    queue.close();
+    for (size_t c = threads; c < workers.size(); ++c) {
+        workers[c].join();
+    }
+    auto finish = std::chrono::steady_clock::now();
+
+    size_t total = threads * itemsPerProducer;
+    size_t expectedSum = threads * (itemsPerProducer * (itemsPerProducer + 1) / 2);
+    if (consumedCount != total || consumedSum != expectedSum) {
+        throw CustomException("ConcurrentQueue lost or duplicated elements");
+    }
+    return 2.0 * static_cast<double>(total) / std::chrono::duration<double>(finish - start).count();
+}
+
+void runMpmcBenchmark() {
+    const size_t totalItems = 4000000;
+    std::cout << "threads (P+C)  batch  Mops/s total  Mops/s per thread" << std::endl;
+    for (size_t threads : {1, 2, 4, 8, 16}) {
+        for (size_t batch : {1, 64}) {
+            double rate = measureConcurrentQueue(threads, totalItems / threads, batch);
+            std::cout << threads << "+" << threads << "\t\t" << batch << "\t" << rate / 1e6
+                      << "\t\t" << rate / 1e6 / static_cast<double>(2 * threads) << std::endl;
+        }
+    }
+}
+
+// ---------- Набор замеров Queue в сравнении с std::deque и std::queue ----------
+
+// Результат одного замера
+struct SuiteResult {
+    std::string benchmark; // Операция (push_pop, fill_drain, ...)
+    std::string container; // Название контейнера
+    std::string type;      // Тип элементов
+    size_t size;           // Число элементов в контейнере
+    size_t iterations;     // Сколько операций было измерено
+    double nsPerOp;        // Среднее время одной операции
+};
+
+template <typename C> struct IsStdDeque : std::false_type {};
+template <typename T, typename A> struct IsStdDeque<std::deque<T, A>> : std::true_type {};
+
+template <typename C> struct IsStdQueue : std::false_type {};
+template <typename T, typename S> struct IsStdQueue<std::queue<T, S>> : std::true_type {};
+
+// Доступ по индексу за O(1) (у NodeStorage он линейный)
+template <typename C> struct HasFastIndex : std::true_type {};
+template <typename T, typename A>
+struct HasFastIndex<containers::Queue<T, containers::NodeStorage<T, A>>> : std::false_type {};
+
+template <typename C, typename T>
+void suitePush(C& c, const T& value) {
+    if constexpr (IsStdDeque<C>::value) {
+        c.push_back(value);
+    } else {
+        c.push(value);
+    }
+}
+
+template <typename C>
+void suitePop(C& c) {
+    if constexpr (IsStdDeque<C>::value) {
+        c.pop_front();
+    } else {
+        c.pop();
+    }
+}
+
+// Значение, которым заполняются контейнеры
+template <typename T>
+T suiteSample() {
+    if constexpr (std::is_same<T, std::string>::value) {
+        return "benchmark string value #"; // Длиннее SSO - каждая копия выделяет память
+    } else {
+        return static_cast<T>(42);
+    }
+}
+
+// Свертка элемента в число, чтобы компилятор не выбросил обход
+template <typename T>
+size_t suiteTouch(const T& value) {
+    if constexpr (std::is_same<T, std::string>::value) {
+        return value.size();
+    } else {
+        return static_cast<size_t>(value);
+    }
+}
+
+volatile size_t suiteSink = 0; // Приемник результатов обходов
+
+template <typename C, typename T>
+void runSuiteFor(const char* containerName, const char* typeName, size_t n, std::vector<SuiteResult>& results) {
+    const T sample = suiteSample<T>();
+    const size_t reps = std::max<size_t>(1, 1000000 / n); // Малые размеры повторяются
+    auto record = [&](const char* benchmark, size_t ops, double ns) {
+        results.push_back({benchmark, containerName, typeName, n, ops, ns});
+        std::cout << benchmark << "/" << containerName << "/" << typeName << "/" << n
+                  << ": " << ns << " ns/op" << std::endl;
+    };
+
+    // Заполнение и освобождение с нуля (пачкой)
+    size_t ops = reps * n;
+    record("fill_drain", 2 * ops, measureNsPerOp(2 * ops, [&] {
+        for (size_t r = 0; r < reps; ++r) {
+            C c;
+            for (size_t i = 0; i < n; ++i) {
+                suitePush(c, sample);
+            }
+            for (size_t i = 0; i < n; ++i) {
+                suitePop(c);
+            }
+        }
+    }));
+
+    C filled;
+    for (size_t i = 0; i < n; ++i) {
+        suitePush(filled, sample);
+    }
+
+    // Установившийся режим: глубина очереди постоянна, push и pop чередуются
+    record("push_pop", ops, measureNsPerOp(ops, [&] {
+        for (size_t i = 0; i < ops; ++i) {
+            suitePush(filled, sample);
+            suitePop(filled);
+        }
+    }));
+
+    // Копирование (на элемент) и перемещение (на операцию)
+    record("copy", ops, measureNsPerOp(ops, [&] {
+        for (size_t r = 0; r < reps; ++r) {
+            C copy(filled);
+            suiteSink = suiteSink + copy.size();
+        }
+    }));
+    record("move", reps, measureNsPerOp(reps, [&] {
+        for (size_t r = 0; r < reps; ++r) {
+            C moved(std::move(filled));
+            filled = std::move(moved);
+        }
+    }));
+
+    // У std::queue нет ни индексов, ни итераторов
+    if constexpr (!IsStdQueue<C>::value) {
+        if (HasFastIndex<C>::value || n <= 10000) {
+            record("index_scan", ops, measureNsPerOp(ops, [&] {
+                size_t sum = 0;
+                for (size_t r = 0; r < reps; ++r) {
+                    for (size_t i = 0; i < n; ++i) {
+                        sum += suiteTouch(filled[i]);
+                    }
+                }
+                suiteSink = sum;
+            }));
+        }
+        record("iterate", ops, measureNsPerOp(ops, [&] {
+            size_t sum = 0;
+            for (size_t r = 0; r < reps; ++r) {
+                for (const auto& value : filled) {
+                    sum += suiteTouch(value);
+                }
+            }
+            suiteSink = sum;
+        }));
+        record("iterate_reverse", ops, measureNsPerOp(ops, [&] {
+            size_t sum = 0;
+            for (size_t r = 0; r < reps; ++r) {
+                for (auto it = filled.rbegin(); it != filled.rend(); ++it) {
+                    sum += suiteTouch(*it);
+                }
+            }
+            suiteSink = sum;
+        }));
+    }
+}
+
+template <typename T>
+void runSuiteForType(const char* typeName, size_t maxSize, std::vector<SuiteResult>& results) {
+    using namespace containers;
+    for (size_t n = 10; n <= maxSize; n *= 10) {
+        runSuiteFor<Queue<T, NodeStorage<T>>, T>("Queue<Node>", typeName, n, results);
+        runSuiteFor<Queue<T, RingStorage<T>>, T>("Queue<Ring>", typeName, n, results);
+        runSuiteFor<std::deque<T>, T>("std::deque", typeName, n, results);
+        runSuiteFor<std::queue<T>, T>("std::queue", typeName, n, results);
+    }
+}
+
+// Запись результатов в JSON для отслеживания регрессий
+void writeSuiteJson(const std::string& filename, const std::vector<SuiteResult>& results) {
+    std::ofstream out(filename);
+    if (!out) {
+        throw CustomException("Cannot open " + filename + " for writing");
+    }
+
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    out << "{\n  \"context\": {\"date\": \"" << date << "\", \"num_cpus\": " << std::thread::hardware_concurrency()
+        << ", \"time_unit\": \"ns\"},\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const SuiteResult& r = results[i];
+        out << "    {\"name\": \"" << r.benchmark << "/" << r.container << "/" << r.type << "/" << r.size
+            << "\", \"benchmark\": \"" << r.benchmark << "\", \"container\": \"" << r.container
+            << "\", \"type\": \"" << r.type << "\", \"size\": " << r.size
+            << ", \"iterations\": " << r.iterations << ", \"ns_per_op\": " << r.nsPerOp << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// laba5 bench-suite [файл.json] [максимальный размер]
+void runBenchmarkSuite(const std::string& filename, size_t maxSize) {
+    std::vector<SuiteResult> results;
+    runSuiteForType<int>("int", maxSize, results);
+    runSuiteForType<double>("double", maxSize, results);
+    runSuiteForType<std::string>("string", maxSize, results);
+    writeSuiteJson(filename, results);
+    std::cout << results.size() << " results written to " << filename << std::endl;
+}
+
+// ---------- Fork/join на Executor ----------
+
+// Последовательное число Фибоначчи (экспоненциальная рекурсия как эталонная нагрузка)
+long long serialFib(int n) {
+    return n < 2 ? n : serialFib(n - 1) + serialFib(n - 2);
+}
+
+// Параллельное число Фибоначчи: ветвь fib(n - 1) отдается в пул, fib(n - 2) считается сразу
+long long parallelFib(containers::Executor& executor, int n) {
+    if (n < 25) {
+        return serialFib(n);
+    }
+    auto left = executor.submit([&executor, n] { return parallelFib(executor, n - 1); });
+    long long right = parallelFib(executor, n - 2);
+    return executor.wait(left) + right;
+}
+
+// Параллельная сумма массива через parallel_for с частичными суммами по кускам
+long long parallelSum(containers::Executor& executor, const std::vector<int>& data) {
+    const size_t chunks = executor.size() * 8;
+    std::vector<long long> partial(chunks, 0);
+    executor.parallel_for(0, chunks, [&](size_t chunk) {
+        size_t begin = data.size() * chunk / chunks;
+        size_t end = data.size() * (chunk + 1) / chunks;
+        long long sum = 0;
+        for (size_t i = begin; i < end; ++i) {
+            sum += data[i];
+        }
+        partial[chunk] = sum;
+    }, 1);
+    long long total = 0;
+    for (long long value : partial) {
+        total += value;
+    }
+    return total;
+}
+
+void runForkJoinBenchmark() {
+    const int fibN = 34;
+    std::vector<int> data(50000000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<int>(i % 1000);
+    }
+
+    // 1, 2, 4, ... потоков и обязательно все ядра
+    size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> threadCounts;
+    for (size_t threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    double fibBase = 0, sumBase = 0;
+    std::cout << "threads  fib(" << fibN << ") ms  speedup  sum(5e7) ms  speedup" << std::endl;
+    for (size_t threads : threadCounts) {
+        containers::Executor executor(threads);
+        long long fibResult = 0, sumResult = 0;
+        double fibMs = measureNsPerOp(1, [&] { fibResult = parallelFib(executor, fibN); }) / 1e6;
+        double sumMs = measureNsPerOp(1, [&] { sumResult = parallelSum(executor, data); }) / 1e6;
+        if (threads == 1) {
+            fibBase = fibMs;
+            sumBase = sumMs;
+        }
+        std::cout << threads << "\t " << fibMs << "\t    " << fibBase / fibMs << "\t     "
+                  << sumMs << "\t  " << sumBase / sumMs
+                  << "   (fib = " << fibResult << ", sum = " << sumResult << ")" << std::endl;
+    }
+}
+
+#ifdef CONTAINERS_HAS_MMAP
+// Пропускная способность SpillingQueue: n элементов проходят через диск,
+// между записью и чтением очередь закрывается и открывается заново
+void runSpillBenchmark(const std::string& directory) {
+    using Item = unsigned long long;
+    const size_t n = 50000000;
+    const double megabytes = static_cast<double>(n * sizeof(Item)) / (1 << 20);
+
+    double pushNs;
+    {
+        containers::SpillingQueue<Item> queue(directory);
+        pushNs = measureNsPerOp(n, [&] {
+            for (Item i = 0; i < n; ++i) {
+                queue.push(i);
+            }
+            queue.sync();
+        });
+        std::cout << "pushed " << queue.size() << " items, " << queue.spilled() << " on disk" << std::endl;
+    }
+
+    containers::SpillingQueue<Item> reopened(directory);
+    bool ordered = reopened.size() == n;
+    double popNs = measureNsPerOp(n, [&] {
+        Item value;
+        for (Item i = 0; i < n && ordered; ++i) {
+            ordered = reopened.try_pop(value) && value == i;
+        }
+    });
+
+    std::cout << "push: " << megabytes / (pushNs * n / 1e9) << " MB/s, pop after reopen: "
+              << megabytes / (popNs * n / 1e9) << " MB/s, order " << (ordered ? "preserved" : "BROKEN")
+              << std::endl;
+}
+#endif
+
+// Накладные расходы политик статистики на чередовании push/pop
+template <typename T, typename Storage, typename Stats>
+double measureStatsOverhead(const T& sample, size_t depth, size_t ops) {
+    containers::Queue<T, Storage, Stats> queue;
+    for (size_t i = 0; i < depth; ++i) {
+        queue.push(sample);
+    }
+    T value;
+    return measureNsPerOp(ops, [&] {
+        for (size_t i = 0; i < ops; ++i) {
+            queue.push(sample);
+            queue.try_pop(value);
+        }
+    });
+}
+
+template <typename T, typename Storage>
+void reportStatsOverhead(const char* name, const T& sample, size_t ops) {
+    using namespace containers;
+    const size_t depth = 1000;
+    double none = measureStatsOverhead<T, Storage, NoStats>(sample, depth, ops);
+    double every = measureStatsOverhead<T, Storage, QueueStats<1>>(sample, depth, ops);
+    double sampled = measureStatsOverhead<T, Storage, QueueStats<64>>(sample, depth, ops);
+    std::cout << name << " push+pop, ns:  NoStats " << none << ", QueueStats<1> " << every << " (+"
+              << (every / none - 1) * 100 << "%), QueueStats<64> " << sampled << " (+"
+              << (sampled / none - 1) * 100 << "%)" << std::endl;
+}
+
+void runStatsBenchmark() {
+    using namespace containers;
+    // Худший случай - самые дешевые операции; строки ближе к реальной нагрузке
+    reportStatsOverhead<int, RingStorage<int>>("int    Ring", 42, 20000000);
+    reportStatsOverhead<std::string, NodeStorage<std::string>>("string Node", "benchmark string value #", 5000000);
+
+    Queue<std::string, NodeStorage<std::string>, QueueStats<8>> queue;
+    for (int i = 0; i < 100; ++i) {
+        queue.emplace(std::to_string(i));
+    }
+    std::string word;
+    for (int i = 0; i < 64; ++i) {
+        queue.pop_front(word);
+    }
+    QueueStatsSnapshot stats = queue.stats();
+    std::cout << "depth " << stats.depth << ", peak " << stats.peakDepth << ", pushes " << stats.pushes
+              << ", pops " << stats.pops << ", allocations " << stats.allocations << ", sampled " << stats.sampled
+              << ", mean wait " << stats.meanWaitNs << " ns, max wait " << stats.maxWaitNs << " ns" << std::endl;
+}
+
+// Путь с исключением против пути с кодом ошибки при доле неудач failureRate.
+// Перед каждым pop элемент добавляется с вероятностью 1 - failureRate, поэтому
+// очередь пуста ровно в заданной доле попыток; для индексации так же выбирается
+// доля индексов за границей очереди
+void reportErrorPaths(double failureRate, size_t ops) {
+    using namespace containers;
+    std::vector<char> fails(ops);
+    unsigned state = 2463534242u;
+    for (size_t i = 0; i < ops; ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        fails[i] = state < failureRate * 4294967296.0;
+    }
+
+    Queue<int, RingStorage<int>> queue;
+    long long sum = 0;
+    size_t failures = 0;
+    double popThrow = measureNsPerOp(ops, [&] {
+        int value = 0;
+        for (size_t i = 0; i < ops; ++i) {
+            if (!fails[i]) {
+                queue.push(static_cast<int>(i));
+            }
+            try {
+                queue.pop_front(value);
+                sum += value;
+            } catch (const CustomException&) {
+                ++failures;
+            }
+        }
+    });
+    double popResult = measureNsPerOp(ops, [&] {
+        for (size_t i = 0; i < ops; ++i) {
+            if (!fails[i]) {
+                queue.push(static_cast<int>(i));
+            }
+            Result<int> value = queue.try_pop();
+            if (value) {
+                sum += *value;
+            } else {
+                ++failures;
+            }
+        }
+    });
+
+    const size_t depth = 64;
+    for (size_t i = 0; i < depth; ++i) {
+        queue.push(static_cast<int>(i));
+    }
+    double indexThrow = measureNsPerOp(ops, [&] {
+        for (size_t i = 0; i < ops; ++i) {
+            try {
+                sum += queue[fails[i] ? depth + i % depth : i % depth];
+            } catch (const CustomException&) {
+                ++failures;
+            }
+        }
+    });
+    double indexResult = measureNsPerOp(ops, [&] {
+        for (size_t i = 0; i < ops; ++i) {
+            Result<int&> value = queue.at_checked(fails[i] ? depth + i % depth : i % depth);
+            if (value) {
+                sum += *value;
+            } else {
+                ++failures;
+            }
+        }
+    });
+
+    std::cout << "failures " << failureRate * 100 << "%: pop throw " << popThrow << " ns, try_pop "
+              << popResult << " ns; operator[] throw " << indexThrow << " ns, at_checked " << indexResult
+              << " ns (checksum " << sum + static_cast<long long>(failures) << ")" << std::endl;
+}
+
+void runErrorPathBenchmark() {
+    for (double failureRate : {0.0, 0.001, 0.01, 0.1, 0.5}) {
+        reportErrorPaths(failureRate, 2000000);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    using namespace containers;
+
+    if (argc > 1 && std::strcmp(argv[1], "bench") == 0) {
+        runStorageBenchmark();
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "bench-suite") == 0) {
+        std::string filename = argc > 2 ? argv[2] : "laba5_bench.json";
+        size_t maxSize = argc > 3 ? std::stoul(argv[3]) : 10000000;
+        runBenchmarkSuite(filename, maxSize);
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "bench-stats") == 0) {
+        runStatsBenchmark();
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "bench-errors") == 0) {
+        runErrorPathBenchmark();
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "bench-alloc") == 0) {
+        runNodePoolBenchmark();
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "bench-spsc") == 0) {
+        runSpscBenchmark();
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "bench-mpmc") == 0) {
+        runMpmcBenchmark();
+        return 0;
+    }
+    if (argc > 1 && std::strcmp(argv[1], "bench-forkjoin") == 0) {
+        runForkJoinBenchmark();
+        return 0;
+    }
+#ifdef CONTAINERS_HAS_MMAP
+    if (argc > 2 && std::strcmp(argv[1], "bench-spill") == 0) {
+        runSpillBenchmark(argv[2]);
+        return 0;
+    }
+#endif
+    if (argc > 1 && std::strcmp(argv[1], "stress-spsc") == 0) {
+        bool ok = stressSpscQueue(5000000, 64, 1) && stressSpscQueue(5000000, 1000, 37);
+        std::cout << "SpscQueue stress test: " << (ok ? "passed" : "FAILED") << std::endl;
+        return ok ? 0 : 1;
+    }
+
+    // Создаем очередь с элементами
+    Queue<int> queue{1, 2, 3, 4, 5};
+
+    // Прямой обход
+    std::cout << "Forward iteration: ";
+    for (int value : queue) {
+        std::cout << value << " ";
+    }
+    std::cout << std::endl;
+
+    // Обратный обход
+    std::cout << "Reverse iteration: ";
+    for (auto it = queue.rbegin(); it != queue.rend(); ++it) {
+        std::cout << *it << " ";
+    }
+    std::cout << std::endl;
+
+    // Стандартные алгоритмы, в том числе параллельные
+    // (для RingStorage итераторы произвольного доступа; libstdc++ тогда требует -ltbb)
+    std::for_each(std::execution::par, queue.begin(), queue.end(), [](int& value) { value *= 10; });
+    std::cout << "Max after par for_each: " << *std::max_element(queue.cbegin(), queue.cend()) << std::endl;
+
+    // Та же очередь на кольцевом буфере
+    Queue<int, RingStorage<int>> ringQueue{1, 2, 3, 4, 5};
+    ringQueue.pop();
+    ringQueue.push(6);
+    std::cout << "Ring storage: ";
+    ringQueue.display();
+
+    // Перемещение строк в очередь и из нее без копирования
+    Queue<std::string> words;
+    words.emplace(3, '!');
+    words.push(std::string("moved"));
+    std::string word;
+    words.pop_front(word);
+    std::cout << "Popped: " << word << ", left: " << words.size() << std::endl;
+
+    // Ошибки без исключений: коды 101 (пустая очередь) и 102 (индекс вне диапазона)
+    Result<std::string> next = words.try_pop();
+    Result<std::string> none = words.try_pop();
+    std::cout << "try_pop: " << next.value_or("") << ", then error " << static_cast<int>(none.error())
+              << "; at_checked(10): error " << static_cast<int>(ringQueue.at_checked(10).error()) << std::endl;
 
     return 0;
 }
@@ -1,13 +1,44 @@
 #include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <vector>
 
-// Структура для хранения данных о прямоугольнике
+// Структура для хранения данных о прямоугольнике: только положение, размер
+// (может быть отрицательным, если тянули влево или вверх) и цвет заливки
 struct Rectangle {
-    sf::RectangleShape shape;
+    sf::Vector2f position;
+    sf::Vector2f size;
     sf::Color fillColor;
 };
 
+// Толщина белой рамки вокруг прямоугольника
+const float OUTLINE_THICKNESS = 1;
+
+// Добавляет в массив два треугольника, закрашивающих [left, right] x [top, bottom]
+void appendQuad(sf::VertexArray& vertices, float left, float top, float right, float bottom, sf::Color color) {
+    vertices.append(sf::Vertex(sf::Vector2f(left, top), color));
+    vertices.append(sf::Vertex(sf::Vector2f(right, top), color));
+    vertices.append(sf::Vertex(sf::Vector2f(right, bottom), color));
+    vertices.append(sf::Vertex(sf::Vector2f(left, top), color));
+    vertices.append(sf::Vertex(sf::Vector2f(right, bottom), color));
+    vertices.append(sf::Vertex(sf::Vector2f(left, bottom), color));
+}
+
+// Добавляет прямоугольник в общий массив вершин: белый квадрат, расширенный
+// на толщину рамки, и поверх него заливка. Заливка непрозрачна, поэтому
+// видимой остается только рамка снаружи - как у sf::RectangleShape с
+// setOutlineThickness(1). Порядок в массиве совпадает с порядком рисования
+void appendRectangle(sf::VertexArray& vertices, const Rectangle& rect) {
+    float left = std::min(rect.position.x, rect.position.x + rect.size.x);
+    float right = std::max(rect.position.x, rect.position.x + rect.size.x);
+    float top = std::min(rect.position.y, rect.position.y + rect.size.y);
+    float bottom = std::max(rect.position.y, rect.position.y + rect.size.y);
+    appendQuad(vertices, left - OUTLINE_THICKNESS, top - OUTLINE_THICKNESS, right + OUTLINE_THICKNESS,
+               bottom + OUTLINE_THICKNESS, sf::Color::White);
+    appendQuad(vertices, left, top, right, bottom, rect.fillColor);
+}
+
 int main() {
     // Создаем окно
     sf::RenderWindow window(sf::VideoMode(800, 600), "Rectangle Drawer");
@@ -15,8 +46,15 @@ int main() {
     // Вектор для хранения всех прямоугольников
     std::vector<Rectangle> rectangles;
 
-    // Текущий прямоугольник
-    Rectangle currentRect;
+    // Вершины всех готовых прямоугольников: новый прямоугольник дописывается
+    // в конец, и все они рисуются одним вызовом draw
+    sf::VertexArray vertices(sf::Triangles);
+
+    // Текущий прямоугольник - пока его тянут, он прозрачный с белой рамкой
+    sf::RectangleShape currentShape;
+    currentShape.setFillColor(sf::Color::Transparent);
+    currentShape.setOutlineColor(sf::Color::White);
+    currentShape.setOutlineThickness(OUTLINE_THICKNESS);
     bool isDrawing = false; // Флаг для проверки, рисуем ли мы сейчас
 
     while (window.isOpen()) {
@@ -28,10 +66,8 @@ int main() {
             // Обработка нажатия мыши
             if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
                 isDrawing = true;
-                currentRect.shape.setPosition(static_cast<float>(event.mouseButton.x), static_cast<float>(event.mouseButton.y));
-                currentRect.shape.setFillColor(sf::Color::Transparent);
-                currentRect.shape.setOutlineColor(sf::Color::White);
-                currentRect.shape.setOutlineThickness(1);
+                currentShape.setPosition(static_cast<float>(event.mouseButton.x), static_cast<float>(event.mouseButton.y));
+                currentShape.setSize(sf::Vector2f(0, 0));
             }
 
             // Обработка отпускания мыши
@@ -44,9 +80,9 @@ int main() {
                         static_cast<sf::Uint8>(rand() % 256),
                         static_cast<sf::Uint8>(rand() % 256)
                     );
-                    currentRect.shape.setFillColor(randomColor);
-                    currentRect.fillColor = randomColor;
-                    rectangles.push_back(currentRect);
+                    Rectangle rect{currentShape.getPosition(), currentShape.getSize(), randomColor};
+                    rectangles.push_back(rect);
+                    appendRectangle(vertices, rect);
                 }
             }
 
@@ -59,23 +95,21 @@ int main() {
         // Обновление прямоугольника при движении мыши
         if (isDrawing) {
             sf::Vector2i mousePos = sf::Mouse::getPosition(window);
-            sf::Vector2f startPos = currentRect.shape.getPosition();
-            currentRect.shape.setSize(sf::Vector2f(static_cast<float>(mousePos.x) - startPos.x,
-                                                  static_cast<float>(mousePos.y) - startPos.y));
+            sf::Vector2f startPos = currentShape.getPosition();
+            currentShape.setSize(sf::Vector2f(static_cast<float>(mousePos.x) - startPos.x,
+                                              static_cast<float>(mousePos.y) - startPos.y));
         }
 
-        // Отрисовка
+        // Отрисовка: все готовые прямоугольники одним вызовом
         window.clear();
-        for (const auto& rect : rectangles) {
-            window.draw(rect.shape);
-        }
+        window.draw(vertices);
 
         if (isDrawing) {
-            window.draw(currentRect.shape);
+            window.draw(currentShape);
         }
 
         window.display();
     }
 
     return 0;
-}
\ No newline at end of file
+}